@@ -52,8 +52,15 @@ docker run --rm \
             -Wextra \
             -O2 \
             -o ${OUTPUT_NAME} \
+            ${SRC_DIR}/AsyncHttpClient.cpp \
+            ${SRC_DIR}/Capture.cpp \
+            ${SRC_DIR}/EventLoop.cpp \
+            ${SRC_DIR}/Logger.cpp \
             ${SRC_DIR}/Mcp3008.cpp \
             ${SRC_DIR}/RestClient.cpp \
+            ${SRC_DIR}/Rollup.cpp \
+            ${SRC_DIR}/SimulatedSignal.cpp \
+            ${SRC_DIR}/UploadController.cpp \
             ${SRC_DIR}/main.cpp \
             -lcurl \
             -lsocket && \
@@ -0,0 +1,245 @@
+/**
+ * @file AsyncHttpClient.cpp
+ * @brief Non-blocking HTTP client implementation (libcurl multi-socket API)
+ */
+
+#include "AsyncHttpClient.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+AsyncHttpClient::AsyncHttpClient(EventLoop& loop, std::string baseUrl)
+    : m_loop(loop)
+    , m_multi(nullptr)
+    , m_baseUrl(std::move(baseUrl))
+    , m_timeout(RestClient::DEFAULT_TIMEOUT_SECONDS)
+    , m_connectTimeout(RestClient::DEFAULT_CONNECT_TIMEOUT_SECONDS)
+    , m_timer(0)
+    , m_requests()
+    , m_sockets()
+    , m_idleHandles()
+{
+    // Initialize libcurl globally exactly once
+    static const CURLcode curlGlobalInit = curl_global_init(CURL_GLOBAL_DEFAULT);
+    if (curlGlobalInit != CURLE_OK) {
+        throw std::runtime_error(
+            std::string("Failed to initialize libcurl: ") +
+            curl_easy_strerror(curlGlobalInit)
+        );
+    }
+
+    m_multi = curl_multi_init();
+    if (!m_multi) {
+        throw std::runtime_error("Failed to create libcurl multi handle");
+    }
+
+    curl_multi_setopt(m_multi, CURLMOPT_SOCKETFUNCTION, socketCallback);
+    curl_multi_setopt(m_multi, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(m_multi, CURLMOPT_TIMERFUNCTION, timerCallback);
+    curl_multi_setopt(m_multi, CURLMOPT_TIMERDATA, this);
+
+    // Remove trailing slash from base URL if present
+    if (!m_baseUrl.empty() && m_baseUrl.back() == '/') {
+        m_baseUrl.pop_back();
+    }
+}
+
+AsyncHttpClient::~AsyncHttpClient() {
+    for (auto& entry : m_requests) {
+        curl_multi_remove_handle(m_multi, entry.first);
+        curl_slist_free_all(entry.second->headers);
+        curl_easy_cleanup(entry.first);
+    }
+    m_requests.clear();
+
+    for (CURL* easy : m_idleHandles) {
+        curl_easy_cleanup(easy);
+    }
+    m_idleHandles.clear();
+
+    curl_multi_cleanup(m_multi);
+    m_multi = nullptr;
+
+    if (m_timer != 0) {
+        m_loop.cancelTimer(m_timer);
+    }
+    for (int fd : m_sockets) {
+        m_loop.unwatchFd(fd);
+    }
+}
+
+void AsyncHttpClient::post(const std::string& endpoint, std::string jsonPayload, Completion done) {
+    auto request = std::make_unique<Request>();
+    request->response = RestClient::Response{false, 0, "", "", 0};
+    request->payload = std::move(jsonPayload);
+    request->done = std::move(done);
+
+    // Build full URL
+    request->url = m_baseUrl;
+    if (!endpoint.empty()) {
+        if (endpoint.front() != '/') {
+            request->url += '/';
+        }
+        request->url += endpoint;
+    }
+
+    // Reuse an idle handle when possible (keeps its allocations warm)
+    if (!m_idleHandles.empty()) {
+        request->easy = m_idleHandles.back();
+        m_idleHandles.pop_back();
+        curl_easy_reset(request->easy);
+    } else {
+        request->easy = curl_easy_init();
+    }
+    if (!request->easy) {
+        request->response.error = "Failed to create libcurl handle";
+        request->done(request->response);
+        return;
+    }
+
+    CURL* easy = request->easy;
+    curl_easy_setopt(easy, CURLOPT_URL, request->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request->payload.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request->payload.size()));
+
+    request->headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    request->headers = curl_slist_append(request->headers, "Accept: application/json");
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, request->headers);
+
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT, m_timeout);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, m_connectTimeout);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &request->response.body);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_MAXREDIRS, 3L);
+
+    // Skip SSL certificate verification (same policy as RestClient)
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, 0L);
+
+    CURLMcode res = curl_multi_add_handle(m_multi, easy);
+    if (res != CURLM_OK) {
+        request->response.error = std::string("Failed to start request: ") + curl_multi_strerror(res);
+        curl_slist_free_all(request->headers);
+        m_idleHandles.push_back(easy);
+        request->done(request->response);
+        return;
+    }
+
+    m_requests.emplace(easy, std::move(request));
+}
+
+size_t AsyncHttpClient::inFlight() const noexcept {
+    return m_requests.size();
+}
+
+void AsyncHttpClient::setTimeout(long timeoutSeconds) {
+    m_timeout = timeoutSeconds;
+}
+
+void AsyncHttpClient::setConnectTimeout(long timeoutSeconds) {
+    m_connectTimeout = timeoutSeconds;
+}
+
+void AsyncHttpClient::socketAction(curl_socket_t fd, int eventMask) {
+    int running = 0;
+    curl_multi_socket_action(m_multi, fd, eventMask, &running);
+    checkCompleted();
+}
+
+void AsyncHttpClient::checkCompleted() {
+    int pending = 0;
+    while (CURLMsg* msg = curl_multi_info_read(m_multi, &pending)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL* easy = msg->easy_handle;
+        CURLcode result = msg->data.result;
+        auto it = m_requests.find(easy);
+        if (it == m_requests.end()) {
+            continue;
+        }
+
+        std::unique_ptr<Request> request = std::move(it->second);
+        m_requests.erase(it);
+        curl_multi_remove_handle(m_multi, easy);
+        curl_slist_free_all(request->headers);
+
+        if (result != CURLE_OK) {
+            request->response.success = false;
+            request->response.error = std::string("HTTP request failed: ") + curl_easy_strerror(result);
+        } else {
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &request->response.httpCode);
+            request->response.retryAfterSeconds = RestClient::retryAfterSeconds(easy);
+            request->response.success = true;
+        }
+        m_idleHandles.push_back(easy);
+
+        // May start new requests; m_requests is not being iterated here
+        request->done(request->response);
+    }
+}
+
+int AsyncHttpClient::socketCallback(CURL* easy, curl_socket_t fd, int what, void* userp, void* socketp) {
+    (void)easy;
+    (void)socketp;
+    auto* self = static_cast<AsyncHttpClient*>(userp);
+
+    if (what == CURL_POLL_REMOVE) {
+        self->m_loop.unwatchFd(fd);
+        self->m_sockets.erase(fd);
+        return 0;
+    }
+
+    short events = 0;
+    if (what == CURL_POLL_IN || what == CURL_POLL_INOUT) {
+        events |= POLLIN;
+    }
+    if (what == CURL_POLL_OUT || what == CURL_POLL_INOUT) {
+        events |= POLLOUT;
+    }
+
+    self->m_sockets.insert(fd);
+    self->m_loop.watchFd(fd, events, [self](int readyFd, short revents) {
+        int mask = 0;
+        if (revents & POLLIN) {
+            mask |= CURL_CSELECT_IN;
+        }
+        if (revents & POLLOUT) {
+            mask |= CURL_CSELECT_OUT;
+        }
+        if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            mask |= CURL_CSELECT_ERR;
+        }
+        self->socketAction(readyFd, mask);
+    });
+    return 0;
+}
+
+int AsyncHttpClient::timerCallback(CURLM* multi, long timeoutMs, void* userp) {
+    (void)multi;
+    auto* self = static_cast<AsyncHttpClient*>(userp);
+
+    if (self->m_timer != 0) {
+        self->m_loop.cancelTimer(self->m_timer);
+        self->m_timer = 0;
+    }
+    if (timeoutMs >= 0) {
+        // Never call socket_action from inside this callback; defer to the loop
+        self->m_timer = self->m_loop.addTimer(timeoutMs, [self] {
+            self->m_timer = 0;
+            self->socketAction(CURL_SOCKET_TIMEOUT, 0);
+        });
+    }
+    return 0;
+}
+
+size_t AsyncHttpClient::writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    size_t totalSize = size * nmemb;
+    auto* body = static_cast<std::string*>(userdata);
+    body->append(ptr, totalSize);
+    return totalSize;
+}
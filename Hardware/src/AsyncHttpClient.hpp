@@ -0,0 +1,141 @@
+/**
+ * @file AsyncHttpClient.hpp
+ * @brief Non-blocking HTTP client driven by an EventLoop
+ *
+ * Uses the libcurl multi-socket API so several requests can be in
+ * flight while the loop keeps sampling. curl tells us which sockets
+ * and timeouts it needs; we register them with the EventLoop and hand
+ * readiness back to curl.
+ */
+
+#ifndef ASYNC_HTTP_CLIENT_HPP
+#define ASYNC_HTTP_CLIENT_HPP
+
+#include "EventLoop.hpp"
+#include "RestClient.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <curl/curl.h>
+
+/**
+ * @class AsyncHttpClient
+ * @brief HTTP POST client whose requests complete via callbacks on the loop thread
+ *
+ * Responses use the same RestClient::Response type as the blocking
+ * client. Completion callbacks run on the loop thread and may start
+ * new requests. Destroying the client aborts in-flight requests
+ * without invoking their callbacks.
+ *
+ * Example usage:
+ * @code
+ *   EventLoop loop;
+ *   AsyncHttpClient client(loop, "https://api.example.com");
+ *   client.post("/data", "{\"value\": 42}", [](const RestClient::Response& r) {
+ *       // runs on the loop thread
+ *   });
+ *   loop.run();
+ * @endcode
+ */
+class AsyncHttpClient {
+public:
+    /// Completion callback
+    using Completion = std::function<void(const RestClient::Response&)>;
+
+    /**
+     * @brief Construct client bound to an event loop
+     * @param loop Event loop that drives the sockets (must outlive the client)
+     * @param baseUrl Base URL for all requests
+     * @throws std::runtime_error if libcurl initialization fails
+     */
+    AsyncHttpClient(EventLoop& loop, std::string baseUrl);
+
+    /**
+     * @brief Destructor - aborts in-flight requests and releases curl handles
+     */
+    ~AsyncHttpClient();
+
+    // Disable copy and move operations (curl callbacks hold this pointer)
+    AsyncHttpClient(const AsyncHttpClient&) = delete;
+    AsyncHttpClient& operator=(const AsyncHttpClient&) = delete;
+
+    /**
+     * @brief Start an HTTP POST with JSON payload
+     * @param endpoint API endpoint (appended to base URL)
+     * @param jsonPayload JSON request body
+     * @param done Called on the loop thread when the request completes or fails
+     */
+    void post(const std::string& endpoint, std::string jsonPayload, Completion done);
+
+    /**
+     * @brief Number of requests currently in flight
+     */
+    size_t inFlight() const noexcept;
+
+    /**
+     * @brief Set request timeout
+     * @param timeoutSeconds Timeout in seconds (0 for no timeout)
+     */
+    void setTimeout(long timeoutSeconds);
+
+    /**
+     * @brief Set connection timeout
+     * @param timeoutSeconds Connection timeout in seconds
+     */
+    void setConnectTimeout(long timeoutSeconds);
+
+private:
+    /**
+     * @struct Request
+     * @brief State owned by one in-flight request
+     */
+    struct Request {
+        CURL* easy;                         ///< libcurl easy handle
+        curl_slist* headers;                ///< Request headers
+        std::string url;                    ///< Full URL (must outlive the transfer)
+        std::string payload;                ///< Request body (must outlive the transfer)
+        RestClient::Response response;      ///< Accumulated response
+        Completion done;                    ///< Completion callback
+    };
+
+    EventLoop& m_loop;                      ///< Driving event loop
+    CURLM* m_multi;                         ///< libcurl multi handle
+    std::string m_baseUrl;                  ///< Base URL for requests
+    long m_timeout;                         ///< Request timeout in seconds
+    long m_connectTimeout;                  ///< Connection timeout in seconds
+    EventLoop::TimerId m_timer;             ///< Pending curl timeout (0 if none)
+    std::unordered_map<CURL*, std::unique_ptr<Request>> m_requests;  ///< In-flight requests
+    std::unordered_set<int> m_sockets;      ///< Sockets registered with the loop
+    std::vector<CURL*> m_idleHandles;       ///< Reusable easy handles
+
+    /**
+     * @brief Let curl act on a socket (or timeout) and reap finished transfers
+     */
+    void socketAction(curl_socket_t fd, int eventMask);
+
+    /**
+     * @brief Complete all finished transfers
+     */
+    void checkCompleted();
+
+    /**
+     * @brief curl socket callback - (un)registers sockets with the loop
+     */
+    static int socketCallback(CURL* easy, curl_socket_t fd, int what, void* userp, void* socketp);
+
+    /**
+     * @brief curl timer callback - schedules curl's timeout on the loop
+     */
+    static int timerCallback(CURLM* multi, long timeoutMs, void* userp);
+
+    /**
+     * @brief libcurl write callback for capturing response body
+     */
+    static size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
+};
+
+#endif // ASYNC_HTTP_CLIENT_HPP
@@ -0,0 +1,336 @@
+/**
+ * @file Capture.cpp
+ * @brief Binary raw-capture recording and replay implementation
+ */
+
+// Feature test macros must come before any includes
+#define _QNX_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "Capture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    /// Largest delta a single record can carry
+    constexpr int64_t MAX_DELTA_US = 0xFFFFFFFFLL;
+
+    /**
+     * @brief Current CLOCK_MONOTONIC time in nanoseconds
+     */
+    int64_t monotonicNs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    /// Largest absolute time a BASE record can carry (56 bits)
+    constexpr int64_t MAX_BASE_US = (1LL << 56) - 1;
+
+    /// Latest monotonic replay deadline offset, far beyond any real recording
+    constexpr double MAX_REPLAY_OFFSET_NS = static_cast<double>(std::numeric_limits<int64_t>::max() / 4);
+
+    /**
+     * @brief Current CLOCK_REALTIME time in microseconds
+     */
+    int64_t realtimeUs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000LL + ts.tv_nsec / 1000;
+    }
+
+    /**
+     * @brief Check header magic, version range and record size
+     */
+    bool validHeader(const CaptureFormat::Header& header, uint16_t minVersion) {
+        return std::memcmp(header.magic, CaptureFormat::MAGIC, sizeof(header.magic)) == 0 &&
+               header.version >= minVersion && header.version <= CaptureFormat::VERSION &&
+               header.recordSize == sizeof(CaptureFormat::Record);
+    }
+
+    /**
+     * @brief Write the whole buffer, retrying on partial writes and EINTR
+     */
+    void writeAll(int fd, const void* data, size_t length, const std::string& path) {
+        const char* p = static_cast<const char*>(data);
+        while (length > 0) {
+            ssize_t n = ::write(fd, p, length);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(
+                    "Failed to write capture file '" + path + "': " + std::strerror(errno)
+                );
+            }
+            p += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+}
+
+// ============ CaptureWriter ============
+
+CaptureWriter::CaptureWriter(const std::string& path)
+    : m_fd(-1)
+    , m_path(path)
+    , m_haveHeader(false)
+    , m_needBase(false)
+    , m_lastMonotonicUs(0)
+    , m_lastFlushUs(0)
+    , m_sampleCount(0)
+    , m_buffered(0)
+    , m_buffer()
+{
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (m_fd < 0) {
+        throw std::runtime_error(
+            "Failed to open capture file '" + path + "': " + std::strerror(errno)
+        );
+    }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        int err = errno;
+        close(m_fd);
+        throw std::runtime_error(
+            "Failed to stat capture file '" + path + "': " + std::strerror(err)
+        );
+    }
+
+    if (st.st_size > 0) {
+        try {
+            resumeExisting(static_cast<size_t>(st.st_size));
+        } catch (...) {
+            close(m_fd);
+            throw;
+        }
+    }
+}
+
+CaptureWriter::~CaptureWriter() {
+    if (m_fd >= 0) {
+        try {
+            flush();
+        } catch (const std::exception&) {
+            // Nothing useful to do on shutdown; data already buffered is lost
+        }
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void CaptureWriter::resumeExisting(size_t fileSize) {
+    CaptureFormat::Header header;
+    if (fileSize < sizeof(header) ||
+        pread(m_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        !validHeader(header, CaptureFormat::MIN_READ_VERSION)) {
+        throw std::runtime_error("'" + m_path + "' is not a capture file");
+    }
+    if (header.version != CaptureFormat::VERSION) {
+        throw std::runtime_error("'" + m_path + "' is an older capture format; record to a new file");
+    }
+
+    // Drop a torn trailing record left by a crash mid-write
+    const size_t recordCount = (fileSize - sizeof(header)) / sizeof(CaptureFormat::Record);
+    const size_t validSize = sizeof(header) + recordCount * sizeof(CaptureFormat::Record);
+    if (validSize != fileSize && ftruncate(m_fd, static_cast<off_t>(validSize)) != 0) {
+        throw std::runtime_error(
+            "Failed to truncate capture file '" + m_path + "': " + std::strerror(errno)
+        );
+    }
+
+    // Monotonic time restarts with each run, so the next sample opens a new session
+    m_needBase = true;
+    m_haveHeader = true;
+}
+
+void CaptureWriter::append(int64_t monotonicUs, uint8_t channel, uint16_t raw) {
+    if (!m_haveHeader) {
+        CaptureFormat::Header header{};
+        std::memcpy(header.magic, CaptureFormat::MAGIC, sizeof(header.magic));
+        header.version = CaptureFormat::VERSION;
+        header.recordSize = sizeof(CaptureFormat::Record);
+        header.baseTimeUs = realtimeUs();
+        writeAll(m_fd, &header, sizeof(header), m_path);
+        m_haveHeader = true;
+        m_lastMonotonicUs = monotonicUs;
+        m_lastFlushUs = monotonicUs;
+    } else if (m_needBase) {
+        const uint64_t baseUs = static_cast<uint64_t>(std::min(std::max<int64_t>(realtimeUs(), 0), MAX_BASE_US));
+        bufferRecord(CaptureFormat::Record{static_cast<uint32_t>(baseUs),
+                                           static_cast<uint16_t>(baseUs >> 32),
+                                           static_cast<uint8_t>(baseUs >> 48),
+                                           CaptureFormat::FLAG_BASE});
+        m_needBase = false;
+        m_lastMonotonicUs = monotonicUs;
+        m_lastFlushUs = monotonicUs;
+    }
+
+    // Monotonic, so only a caller passing out-of-order times can make this negative
+    int64_t delta = std::max<int64_t>(0, monotonicUs - m_lastMonotonicUs);
+    while (delta > MAX_DELTA_US) {
+        bufferRecord(CaptureFormat::Record{static_cast<uint32_t>(MAX_DELTA_US), 0, 0,
+                                           CaptureFormat::FLAG_GAP});
+        delta -= MAX_DELTA_US;
+    }
+    bufferRecord(CaptureFormat::Record{static_cast<uint32_t>(delta), raw, channel, 0});
+    m_lastMonotonicUs = std::max(m_lastMonotonicUs, monotonicUs);
+    m_sampleCount++;
+
+    if (monotonicUs - m_lastFlushUs >= FLUSH_INTERVAL_US) {
+        flush();
+        m_lastFlushUs = monotonicUs;
+    }
+}
+
+void CaptureWriter::flush() {
+    if (m_buffered == 0) {
+        return;
+    }
+    writeAll(m_fd, m_buffer.data(), m_buffered * sizeof(CaptureFormat::Record), m_path);
+    m_buffered = 0;
+}
+
+uint64_t CaptureWriter::sampleCount() const noexcept {
+    return m_sampleCount;
+}
+
+void CaptureWriter::bufferRecord(const CaptureFormat::Record& record) {
+    if (m_buffered == BUFFER_RECORDS) {
+        flush();
+    }
+    m_buffer[m_buffered++] = record;
+}
+
+// ============ CaptureReader ============
+
+CaptureReader::CaptureReader(const std::string& path)
+    : m_map(nullptr)
+    , m_mapSize(0)
+    , m_records(nullptr)
+    , m_recordCount(0)
+    , m_index(0)
+    , m_timestampUs(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(
+            "Failed to open capture file '" + path + "': " + std::strerror(errno)
+        );
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CaptureFormat::Header)) {
+        close(fd);
+        throw std::runtime_error("'" + path + "' is not a capture file");
+    }
+
+    m_mapSize = static_cast<size_t>(st.st_size);
+    m_map = mmap(nullptr, m_mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // Mapping stays valid after close
+    if (m_map == MAP_FAILED) {
+        m_map = nullptr;
+        throw std::runtime_error(
+            "Failed to map capture file '" + path + "': " + std::strerror(errno)
+        );
+    }
+
+    const auto* header = static_cast<const CaptureFormat::Header*>(m_map);
+    if (!validHeader(*header, CaptureFormat::MIN_READ_VERSION)) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        throw std::runtime_error("'" + path + "' is not a capture file");
+    }
+
+    m_records = reinterpret_cast<const CaptureFormat::Record*>(header + 1);
+    m_recordCount = (m_mapSize - sizeof(CaptureFormat::Header)) / sizeof(CaptureFormat::Record);
+    m_timestampUs = header->baseTimeUs;
+}
+
+CaptureReader::~CaptureReader() {
+    if (m_map != nullptr) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+    }
+}
+
+bool CaptureReader::next(CaptureSample& out) noexcept {
+    while (m_index < m_recordCount) {
+        const CaptureFormat::Record& record = m_records[m_index++];
+        if (record.flags & CaptureFormat::FLAG_BASE) {
+            m_timestampUs = static_cast<int64_t>(static_cast<uint64_t>(record.deltaUs) |
+                                                 static_cast<uint64_t>(record.raw) << 32 |
+                                                 static_cast<uint64_t>(record.channel) << 48);
+            continue;
+        }
+        m_timestampUs += record.deltaUs;
+        if (record.flags & CaptureFormat::FLAG_GAP) {
+            continue;
+        }
+        out.timestampUs = m_timestampUs;
+        out.raw = record.raw;
+        out.channel = record.channel;
+        return true;
+    }
+    return false;
+}
+
+size_t CaptureReader::recordCount() const noexcept {
+    return m_recordCount;
+}
+
+// ============ ReplaySource ============
+
+ReplaySource::ReplaySource(const std::string& path, double speed)
+    : m_reader(path)
+    , m_speed(speed)
+    , m_started(false)
+    , m_lastUs(0)
+    , m_elapsedUs(0)
+    , m_startNs(0)
+{
+    if (!(speed == 0.0 || (std::isfinite(speed) && speed >= MIN_SPEED))) {
+        throw std::invalid_argument("Replay speed must be 0 or a finite value >= 0.001");
+    }
+}
+
+bool ReplaySource::read(CaptureSample& out, int64_t& dueNs) noexcept {
+    if (!m_reader.next(out)) {
+        return false;
+    }
+
+    if (!m_started) {
+        m_started = true;
+        m_lastUs = out.timestampUs;
+        m_startNs = monotonicNs();
+        dueNs = m_startNs;
+        return true;
+    }
+
+    // Shorten long pauses; a jump backwards (new session, clock set back) counts as none
+    m_elapsedUs += std::min(std::max<int64_t>(0, out.timestampUs - m_lastUs), MAX_GAP_US);
+    m_lastUs = out.timestampUs;
+
+    if (m_speed > 0) {
+        // Absolute deadline relative to replay start, so pacing never drifts
+        const double offsetNs = static_cast<double>(m_elapsedUs) * 1000.0 / m_speed;
+        dueNs = m_startNs + static_cast<int64_t>(std::min(offsetNs, MAX_REPLAY_OFFSET_NS));
+    } else {
+        dueNs = m_startNs;
+    }
+    return true;
+}
+
+size_t ReplaySource::recordCount() const noexcept {
+    return m_reader.recordCount();
+}
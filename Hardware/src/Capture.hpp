@@ -0,0 +1,267 @@
+/**
+ * @file Capture.hpp
+ * @brief Binary raw-capture recording and replay
+ *
+ * Records the raw readChannel() stream with timestamps to a compact
+ * append-only file, and replays such files through the pipeline at
+ * real time (or scaled) or as fast as possible.
+ *
+ * File layout (little-endian, matching aarch64 and x86 hosts):
+ *   Header (32 bytes): magic "BRCP", version, record size, base time
+ *   Records (8 bytes each): time delta, raw value, channel, flags
+ *
+ * Timestamps are delta-encoded in microseconds from the previous
+ * record (the first from the header's base time). Deltas come from
+ * CLOCK_MONOTONIC, so wall clock steps (NTP at boot) cannot distort
+ * them; wall time is only read for the header and for a BASE record
+ * that starts each later recording session in the same file. Gaps
+ * longer than a 32-bit delta are written as GAP records that carry
+ * no sample.
+ */
+
+#ifndef CAPTURE_HPP
+#define CAPTURE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace CaptureFormat
+ * @brief On-disk structures for capture files
+ */
+namespace CaptureFormat {
+    /// File magic
+    constexpr char MAGIC[4] = {'B', 'R', 'C', 'P'};
+
+    /// Current format version (2 added BASE records)
+    constexpr uint16_t VERSION = 2;
+
+    /// Oldest version readers still accept
+    constexpr uint16_t MIN_READ_VERSION = 1;
+
+    /// Record flag: advance time by deltaUs without a sample
+    constexpr uint8_t FLAG_GAP = 0x01;
+
+    /// Record flag: restart the running time at an absolute Unix time in
+    /// microseconds, without a sample. deltaUs holds bits 0-31, raw bits
+    /// 32-47 and channel bits 48-55.
+    constexpr uint8_t FLAG_BASE = 0x02;
+
+    /**
+     * @struct Header
+     * @brief File header, written once when the file is created
+     */
+    struct Header {
+        char magic[4];          ///< "BRCP"
+        uint16_t version;       ///< Format version
+        uint16_t recordSize;    ///< sizeof(Record), for forward compatibility
+        int64_t baseTimeUs;     ///< Unix microseconds of the first record
+        uint8_t reserved[16];   ///< Zero
+    };
+
+    /**
+     * @struct Record
+     * @brief One captured sample (or time gap)
+     */
+    struct Record {
+        uint32_t deltaUs;       ///< Microseconds since previous record
+        uint16_t raw;           ///< Raw ADC value
+        uint8_t channel;        ///< ADC channel
+        uint8_t flags;          ///< FLAG_* bits
+    };
+
+    static_assert(sizeof(Header) == 32, "Capture header must be 32 bytes");
+    static_assert(sizeof(Record) == 8, "Capture record must be 8 bytes");
+}
+
+/**
+ * @struct CaptureSample
+ * @brief Decoded sample from a capture file
+ */
+struct CaptureSample {
+    int64_t timestampUs;    ///< Unix microseconds
+    uint16_t raw;           ///< Raw ADC value
+    uint8_t channel;        ///< ADC channel
+};
+
+/**
+ * @class CaptureWriter
+ * @brief Append-only writer for capture files
+ *
+ * Creates the file if needed, or continues an existing capture (a
+ * partially written trailing record from a crash is truncated away)
+ * starting with a BASE record, since monotonic time does not carry
+ * over between runs.
+ * Records are buffered and written in batches at least once per
+ * FLUSH_INTERVAL_US, so capture costs one write() per batch.
+ *
+ * Example usage:
+ * @code
+ *   CaptureWriter capture("/var/log/breath.cap");
+ *   capture.append(monotonicUs, 0, adc.readChannel(0));
+ * @endcode
+ */
+class CaptureWriter {
+public:
+    /// Records buffered before a forced write
+    static constexpr size_t BUFFER_RECORDS = 256;
+
+    /// Maximum time records stay buffered
+    static constexpr int64_t FLUSH_INTERVAL_US = 1000000;
+
+    /**
+     * @brief Open (or create) a capture file for appending
+     * @param path File path
+     * @throws std::runtime_error if the file cannot be opened or is not a
+     *         capture file of the current version
+     */
+    explicit CaptureWriter(const std::string& path);
+
+    /**
+     * @brief Destructor - flushes buffered records and closes the file
+     */
+    ~CaptureWriter();
+
+    // Disable copy and move operations (owns file descriptor and buffer)
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @brief Append one sample
+     * @param monotonicUs Sample time as CLOCK_MONOTONIC microseconds
+     * @param channel ADC channel
+     * @param raw Raw ADC value
+     * @throws std::runtime_error if a buffered write fails
+     */
+    void append(int64_t monotonicUs, uint8_t channel, uint16_t raw);
+
+    /**
+     * @brief Write all buffered records to the file
+     * @throws std::runtime_error if the write fails
+     */
+    void flush();
+
+    /**
+     * @brief Number of samples appended by this writer
+     */
+    uint64_t sampleCount() const noexcept;
+
+private:
+    int m_fd;                       ///< File descriptor (O_APPEND)
+    std::string m_path;             ///< File path (for error messages)
+    bool m_haveHeader;              ///< false until the header is written
+    bool m_needBase;                ///< Resumed file: next sample starts a new session
+    int64_t m_lastMonotonicUs;      ///< Monotonic time of the last sample appended
+    int64_t m_lastFlushUs;          ///< Monotonic time of last flush
+    uint64_t m_sampleCount;         ///< Samples appended
+    size_t m_buffered;              ///< Records in m_buffer
+    std::array<CaptureFormat::Record, BUFFER_RECORDS> m_buffer;  ///< Pending records
+
+    /**
+     * @brief Validate an existing file and drop a torn trailing record
+     */
+    void resumeExisting(size_t fileSize);
+
+    /**
+     * @brief Add a record to the buffer, flushing if it is full
+     */
+    void bufferRecord(const CaptureFormat::Record& record);
+};
+
+/**
+ * @class CaptureReader
+ * @brief Memory-mapped sequential reader for capture files
+ */
+class CaptureReader {
+public:
+    /**
+     * @brief Map a capture file for reading
+     * @param path File path
+     * @throws std::runtime_error if the file cannot be mapped or is not a capture file
+     */
+    explicit CaptureReader(const std::string& path);
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~CaptureReader();
+
+    // Disable copy and move operations (owns mapping)
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    /**
+     * @brief Decode the next sample
+     * @param out Receives the sample
+     * @return false at end of file
+     */
+    bool next(CaptureSample& out) noexcept;
+
+    /**
+     * @brief Number of records (samples and gaps) in the file
+     */
+    size_t recordCount() const noexcept;
+
+private:
+    void* m_map;                            ///< Mapped file
+    size_t m_mapSize;                       ///< Mapped length
+    const CaptureFormat::Record* m_records; ///< First record
+    size_t m_recordCount;                   ///< Complete records in file
+    size_t m_index;                         ///< Next record to read
+    int64_t m_timestampUs;                  ///< Running timestamp
+};
+
+/**
+ * @class ReplaySource
+ * @brief Paced sample source backed by a capture file
+ *
+ * Schedules samples at the pace they were recorded, scaled by a speed
+ * factor, or as fast as possible when speed is 0. It never sleeps: each
+ * sample comes with an absolute monotonic deadline for the caller to
+ * wait on (e.g. an event loop timer), so pacing does not drift with
+ * per-sample work. Pauses between samples (device off, or a jump
+ * between recording sessions) are shortened to MAX_GAP_US.
+ */
+class ReplaySource {
+public:
+    /// Slowest paced playback speed accepted
+    static constexpr double MIN_SPEED = 0.001;
+
+    /// Longest recorded pause between samples reproduced when paced
+    static constexpr int64_t MAX_GAP_US = 10000000;
+
+    /**
+     * @brief Open a capture file for replay
+     * @param path Capture file path
+     * @param speed Playback speed (1.0 = real time, 0 = as fast as possible)
+     * @throws std::invalid_argument if speed is neither 0 nor a finite value >= MIN_SPEED
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    ReplaySource(const std::string& path, double speed);
+
+    /**
+     * @brief Return the next sample and when it is due, without waiting
+     * @param out Receives the sample (with its recorded timestamp)
+     * @param dueNs Receives the CLOCK_MONOTONIC time the sample is due
+     *              (now for the first sample or when unpaced)
+     * @return false at end of recording
+     */
+    bool read(CaptureSample& out, int64_t& dueNs) noexcept;
+
+    /**
+     * @brief Number of records in the recording
+     */
+    size_t recordCount() const noexcept;
+
+private:
+    CaptureReader m_reader;     ///< Underlying file
+    double m_speed;             ///< Playback speed (0 = unpaced)
+    bool m_started;             ///< true after the first sample
+    int64_t m_lastUs;           ///< Recorded time of the previous sample
+    int64_t m_elapsedUs;        ///< Recorded time since the first sample, gaps shortened
+    int64_t m_startNs;          ///< Monotonic time replay started
+};
+
+#endif // CAPTURE_HPP
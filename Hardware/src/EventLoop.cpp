@@ -0,0 +1,237 @@
+/**
+ * @file EventLoop.cpp
+ * @brief Single-threaded reactor implementation
+ */
+
+// Feature test macros must come before any includes
+#define _QNX_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "EventLoop.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /// Write end of the active loop's signal pipe (used by the signal handler)
+    volatile sig_atomic_t g_signalWriteFd = -1;
+
+    /// Longest single poll() wait; far deadlines are reached over several waits
+    constexpr int64_t MAX_POLL_TIMEOUT_MS = 60000;
+
+    /**
+     * @brief Set O_NONBLOCK and FD_CLOEXEC on a descriptor
+     */
+    bool makeNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 &&
+               fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+               fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+    }
+}
+
+EventLoop::EventLoop()
+    : m_heap()
+    , m_timers()
+    , m_watches()
+    , m_signals()
+    , m_pollFds()
+    , m_nextTimerId(1)
+    , m_signalPipe{-1, -1}
+    , m_running(false)
+{
+    if (pipe(m_signalPipe) != 0) {
+        throw std::runtime_error(std::string("Failed to create signal pipe: ") + std::strerror(errno));
+    }
+    if (!makeNonBlocking(m_signalPipe[0]) || !makeNonBlocking(m_signalPipe[1])) {
+        int err = errno;
+        close(m_signalPipe[0]);
+        close(m_signalPipe[1]);
+        throw std::runtime_error(std::string("Failed to configure signal pipe: ") + std::strerror(err));
+    }
+}
+
+EventLoop::~EventLoop() {
+    for (const auto& entry : m_signals) {
+        std::signal(entry.first, SIG_DFL);
+    }
+    if (g_signalWriteFd == m_signalPipe[1]) {
+        g_signalWriteFd = -1;
+    }
+    close(m_signalPipe[0]);
+    close(m_signalPipe[1]);
+}
+
+EventLoop::TimerId EventLoop::addTimer(int64_t delayMs, Callback callback, int64_t periodMs) {
+    TimerId id = m_nextTimerId++;
+    int64_t deadline = nowNs() + delayMs * 1000000LL;
+    m_timers[id] = Timer{deadline, periodMs * 1000000LL, std::move(callback)};
+    m_heap.emplace(deadline, id);
+    return id;
+}
+
+EventLoop::TimerId EventLoop::addTimerAt(int64_t deadlineNs, Callback callback) {
+    TimerId id = m_nextTimerId++;
+    m_timers[id] = Timer{deadlineNs, 0, std::move(callback)};
+    m_heap.emplace(deadlineNs, id);
+    return id;
+}
+
+void EventLoop::cancelTimer(TimerId id) {
+    // Heap entry becomes stale and is skipped when it reaches the top
+    m_timers.erase(id);
+}
+
+void EventLoop::watchFd(int fd, short events, IoCallback callback) {
+    m_watches[fd] = Watch{events, std::move(callback)};
+}
+
+void EventLoop::unwatchFd(int fd) {
+    m_watches.erase(fd);
+}
+
+void EventLoop::watchSignal(int signum, Callback callback) {
+    m_signals[signum] = std::move(callback);
+    g_signalWriteFd = m_signalPipe[1];
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &EventLoop::signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;  // No SA_RESTART: let poll() return EINTR promptly
+    sigaction(signum, &action, nullptr);
+}
+
+void EventLoop::run() {
+    m_running = true;
+    while (m_running) {
+        runDueTimers();
+        if (!m_running) {
+            break;
+        }
+
+        m_pollFds.clear();
+        m_pollFds.push_back(pollfd{m_signalPipe[0], POLLIN, 0});
+        for (const auto& entry : m_watches) {
+            m_pollFds.push_back(pollfd{entry.first, entry.second.events, 0});
+        }
+
+        int ready = poll(m_pollFds.data(), m_pollFds.size(), pollTimeoutMs());
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;  // Signal byte is in the pipe; picked up next round
+            }
+            throw std::runtime_error(std::string("poll() failed: ") + std::strerror(errno));
+        }
+
+        if (m_pollFds[0].revents & POLLIN) {
+            dispatchSignals();
+        }
+        for (size_t i = 1; i < m_pollFds.size() && m_running; ++i) {
+            const pollfd& pfd = m_pollFds[i];
+            if (pfd.revents == 0) {
+                continue;
+            }
+            // An earlier callback this round may have removed the watch
+            auto it = m_watches.find(pfd.fd);
+            if (it == m_watches.end()) {
+                continue;
+            }
+            IoCallback callback = it->second.callback;  // Copy: callback may unwatch itself
+            callback(pfd.fd, pfd.revents);
+        }
+    }
+}
+
+void EventLoop::stop() noexcept {
+    m_running = false;
+}
+
+int64_t EventLoop::nowNs() noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void EventLoop::runDueTimers() {
+    const int64_t now = nowNs();
+    while (!m_heap.empty() && m_heap.top().first <= now && m_running) {
+        HeapEntry entry = m_heap.top();
+        m_heap.pop();
+
+        auto it = m_timers.find(entry.second);
+        if (it == m_timers.end() || it->second.deadlineNs != entry.first) {
+            continue;  // Cancelled or rescheduled
+        }
+
+        Callback callback;
+        if (it->second.periodNs > 0) {
+            // Next tick on the original grid, skipping ticks missed entirely
+            Timer& timer = it->second;
+            int64_t missed = (now - timer.deadlineNs) / timer.periodNs;
+            timer.deadlineNs += (missed + 1) * timer.periodNs;
+            m_heap.emplace(timer.deadlineNs, entry.second);
+            callback = timer.callback;
+        } else {
+            callback = std::move(it->second.callback);
+            m_timers.erase(it);
+        }
+        callback();
+    }
+}
+
+int EventLoop::pollTimeoutMs() {
+    // Drop stale entries so they do not cause early wakeups
+    while (!m_heap.empty()) {
+        auto it = m_timers.find(m_heap.top().second);
+        if (it != m_timers.end() && it->second.deadlineNs == m_heap.top().first) {
+            break;
+        }
+        m_heap.pop();
+    }
+    if (m_heap.empty()) {
+        return -1;
+    }
+
+    int64_t remainingNs = m_heap.top().first - nowNs();
+    if (remainingNs <= 0) {
+        return 0;
+    }
+    // Round up so we never wake before the deadline and spin
+    const int64_t timeoutMs = remainingNs / 1000000 + (remainingNs % 1000000 != 0);
+    return static_cast<int>(timeoutMs < MAX_POLL_TIMEOUT_MS ? timeoutMs : MAX_POLL_TIMEOUT_MS);
+}
+
+void EventLoop::dispatchSignals() {
+    unsigned char signums[32];
+    for (;;) {
+        ssize_t n = read(m_signalPipe[0], signums, sizeof(signums));
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; ++i) {
+            auto it = m_signals.find(signums[i]);
+            if (it != m_signals.end()) {
+                Callback callback = it->second;
+                callback();
+            }
+        }
+    }
+}
+
+void EventLoop::signalHandler(int signum) {
+    int savedErrno = errno;
+    int fd = g_signalWriteFd;
+    if (fd >= 0) {
+        unsigned char byte = static_cast<unsigned char>(signum);
+        ssize_t ignored = write(fd, &byte, 1);
+        (void)ignored;
+    }
+    errno = savedErrno;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file EventLoop.hpp
+ * @brief Single-threaded reactor for timers, file descriptors and signals
+ *
+ * Multiplexes everything the sensor waits on (sampling ticks, curl
+ * sockets, shutdown signals) onto one thread with poll(). Uses only
+ * POSIX facilities so it runs unchanged on QNX Neutrino, which has no
+ * epoll, timerfd or signalfd, and on Linux hosts.
+ */
+
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <poll.h>
+
+/**
+ * @class EventLoop
+ * @brief poll()-based reactor with monotonic timers and self-pipe signals
+ *
+ * Timers are kept in a min-heap of CLOCK_MONOTONIC deadlines; the
+ * nearest one sets the poll() timeout. Periodic timers are rescheduled
+ * from their previous deadline so they do not drift, skipping ticks
+ * that were missed entirely. Signals are delivered through a
+ * self-pipe: the async-signal handler only writes the signal number,
+ * and the callback runs on the loop thread.
+ *
+ * Callbacks may add or remove timers and watches, including their own.
+ *
+ * Example usage:
+ * @code
+ *   EventLoop loop;
+ *   loop.addTimer(250, [&] { sample(); }, 250);
+ *   loop.watchSignal(SIGINT, [&] { loop.stop(); });
+ *   loop.run();
+ * @endcode
+ */
+class EventLoop {
+public:
+    /// Timer identifier (0 is never a valid id)
+    using TimerId = uint64_t;
+
+    /// Timer or signal callback
+    using Callback = std::function<void()>;
+
+    /// File descriptor callback, receives poll() revents
+    using IoCallback = std::function<void(int fd, short revents)>;
+
+    /**
+     * @brief Construct loop and its signal self-pipe
+     * @throws std::runtime_error if the pipe cannot be created
+     */
+    EventLoop();
+
+    /**
+     * @brief Destructor - restores default signal dispositions and closes the pipe
+     */
+    ~EventLoop();
+
+    // Disable copy and move operations (owns pipe and signal handlers)
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Schedule a callback
+     * @param delayMs Delay before first run in milliseconds
+     * @param callback Function to run on the loop thread
+     * @param periodMs Repeat interval in milliseconds (0 = one-shot)
+     * @return Timer id for cancelTimer()
+     */
+    TimerId addTimer(int64_t delayMs, Callback callback, int64_t periodMs = 0);
+
+    /**
+     * @brief Schedule a one-shot callback at an absolute monotonic time
+     * @param deadlineNs CLOCK_MONOTONIC time in nanoseconds
+     * @param callback Function to run on the loop thread
+     * @return Timer id for cancelTimer()
+     */
+    TimerId addTimerAt(int64_t deadlineNs, Callback callback);
+
+    /**
+     * @brief Cancel a pending timer (no-op if already fired or cancelled)
+     */
+    void cancelTimer(TimerId id);
+
+    /**
+     * @brief Watch a file descriptor, replacing any existing watch
+     * @param fd Descriptor to watch
+     * @param events poll() events (POLLIN, POLLOUT)
+     * @param callback Called with revents when ready
+     */
+    void watchFd(int fd, short events, IoCallback callback);
+
+    /**
+     * @brief Stop watching a file descriptor
+     */
+    void unwatchFd(int fd);
+
+    /**
+     * @brief Deliver a signal to a callback on the loop thread
+     * @param signum Signal number (e.g. SIGINT)
+     * @param callback Function to run when the signal arrives
+     */
+    void watchSignal(int signum, Callback callback);
+
+    /**
+     * @brief Dispatch events until stop() is called
+     */
+    void run();
+
+    /**
+     * @brief Make run() return after the current dispatch round
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Current CLOCK_MONOTONIC time in nanoseconds
+     */
+    static int64_t nowNs() noexcept;
+
+private:
+    /**
+     * @struct Timer
+     * @brief Scheduled callback
+     */
+    struct Timer {
+        int64_t deadlineNs;     ///< Next due time
+        int64_t periodNs;       ///< Repeat interval (0 = one-shot)
+        Callback callback;      ///< Function to run
+    };
+
+    /**
+     * @struct Watch
+     * @brief Watched file descriptor
+     */
+    struct Watch {
+        short events;           ///< Requested poll() events
+        IoCallback callback;    ///< Readiness callback
+    };
+
+    /// Heap entry: deadline and timer id (stale entries are skipped)
+    using HeapEntry = std::pair<int64_t, TimerId>;
+
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> m_heap;
+    std::unordered_map<TimerId, Timer> m_timers;    ///< Live timers by id
+    std::unordered_map<int, Watch> m_watches;       ///< Watched descriptors
+    std::unordered_map<int, Callback> m_signals;    ///< Signal callbacks
+    std::vector<struct pollfd> m_pollFds;           ///< Scratch array for poll()
+    TimerId m_nextTimerId;                          ///< Next id to hand out
+    int m_signalPipe[2];                            ///< Self-pipe (read, write)
+    bool m_running;                                 ///< false once stop() is called
+
+    /**
+     * @brief Run all timers whose deadline has passed
+     */
+    void runDueTimers();
+
+    /**
+     * @brief Milliseconds until the next timer (-1 if none)
+     */
+    int pollTimeoutMs();
+
+    /**
+     * @brief Read pending signal numbers from the pipe and dispatch them
+     */
+    void dispatchSignals();
+
+    /**
+     * @brief Async-signal-safe handler that forwards to the self-pipe
+     */
+    static void signalHandler(int signum);
+};
+
+#endif // EVENT_LOOP_HPP
@@ -0,0 +1,390 @@
+/**
+ * @file Logger.cpp
+ * @brief Asynchronous logger implementation
+ */
+
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+    /// Longest writer wait without a wakeup (bounds suppression-notice delay)
+    constexpr auto IDLE_WAIT = std::chrono::seconds(1);
+
+    /// How often the writer re-reads the wall clock offset
+    constexpr int64_t REALTIME_SYNC_NS = 60LL * 1000000000LL;
+
+    /// Size of the writer's output buffer
+    constexpr size_t OUTPUT_BUFFER_SIZE = 16384;
+
+    /// Maximum formatted line length
+    constexpr size_t MAX_LINE_LENGTH = 512;
+
+    static_assert((Logger::CAPACITY & (Logger::CAPACITY - 1)) == 0,
+                  "Logger capacity must be a power of two");
+
+    /**
+     * @brief Level name as printed in the log
+     */
+    const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Info:  return "INFO";
+            case LogLevel::Warn:  return "WARN";
+            case LogLevel::Error: return "ERROR";
+        }
+        return "?";
+    }
+
+    /**
+     * @brief Write the whole buffer to stderr, retrying on partial writes and EINTR
+     */
+    void writeAll(const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t n = ::write(STDERR_FILENO, data, length);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return;  // Nowhere to log a logging failure; drop the rest
+            }
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+
+    /**
+     * @brief Append printf-style text, clamping at the end of the buffer
+     */
+    template <typename... Args>
+    void appendf(char* out, size_t size, size_t& pos, const char* fmt, Args... args) {
+        if (pos >= size) {
+            return;
+        }
+        int n = std::snprintf(out + pos, size - pos, fmt, args...);
+        if (n > 0) {
+            pos = std::min(size - 1, pos + static_cast<size_t>(n));
+        }
+    }
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_slots(new Slot[CAPACITY])
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_dropped(0)
+    , m_reportedDropped(0)
+    , m_written(0)
+    , m_sites(nullptr)
+    , m_running(true)
+    , m_writerIdle(false)
+    , m_realtimeOffsetNs(0)
+    , m_realtimeSyncNs(0)
+{
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    syncRealtimeOffset();
+
+    m_writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_wake.notify_one();
+    m_drained.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    delete[] m_slots;
+}
+
+void Logger::flush() {
+    const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+    wakeWriter();
+
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_drained.wait(lock, [this, target] {
+        return m_written.load(std::memory_order_acquire) >= target ||
+               !m_running.load(std::memory_order_acquire);
+    });
+}
+
+uint64_t Logger::dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+bool Logger::admit(LogSite& site, int64_t now, uint32_t& suppressed) noexcept {
+    int64_t windowStart = site.windowStartNs.load(std::memory_order_relaxed);
+    if (now - windowStart >= LogSite::WINDOW_NS) {
+        // New window; if several threads race here one wins and the
+        // others simply count against the fresh window
+        if (site.windowStartNs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+            site.windowCount.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= LogSite::MAX_PER_WINDOW) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::registerSite(LogSite& site, const char* format) noexcept {
+    bool expected = false;
+    if (!site.registered.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return;
+    }
+    site.format = format;
+    LogSite* head = m_sites.load(std::memory_order_relaxed);
+    do {
+        site.next = head;
+    } while (!m_sites.compare_exchange_weak(head, &site, std::memory_order_release,
+                                            std::memory_order_relaxed));
+}
+
+Logger::Slot* Logger::claim(size_t& position) noexcept {
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[pos & (CAPACITY - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                position = pos;
+                return &slot;
+            }
+        } else if (diff < 0) {
+            // Writer has not consumed this slot yet: ring is full
+            return nullptr;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::publish(Slot* slot, size_t position) noexcept {
+    slot->sequence.store(position + 1, std::memory_order_release);
+    // Pairs with the fence in writerLoop: either the writer sees this
+    // record before it waits, or we see that it is idle and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeWriter();
+}
+
+void Logger::wakeWriter() noexcept {
+    // Only the first producer after the writer went idle takes the lock
+    if (m_writerIdle.load(std::memory_order_relaxed) &&
+        m_writerIdle.exchange(false, std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    while (m_running.load(std::memory_order_acquire)) {
+        if (drain() > 0) {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_drained.notify_all();
+            continue;
+        }
+
+        if (monotonicNs() - m_realtimeSyncNs >= REALTIME_SYNC_NS) {
+            syncRealtimeOffset();
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_writerIdle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Timed so rate-limit suppression notices still come out when idle
+        m_wake.wait_for(lock, IDLE_WAIT, [this] {
+            return pending() || !m_running.load(std::memory_order_acquire);
+        });
+        m_writerIdle.store(false, std::memory_order_relaxed);
+    }
+    // Final drain so nothing logged before shutdown is lost
+    drain();
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_drained.notify_all();
+}
+
+bool Logger::pending() const noexcept {
+    const Slot& slot = m_slots[m_dequeuePos & (CAPACITY - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == m_dequeuePos + 1;
+}
+
+void Logger::syncRealtimeOffset() noexcept {
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    m_realtimeSyncNs = monotonicNs();
+    m_realtimeOffsetNs = static_cast<int64_t>(realtime.tv_sec) * 1000000000LL + realtime.tv_nsec
+                         - m_realtimeSyncNs;
+}
+
+size_t Logger::drain() {
+    char buffer[OUTPUT_BUFFER_SIZE];
+    size_t used = 0;
+    size_t count = 0;
+
+    for (;;) {
+        Slot& slot = m_slots[m_dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+            break;
+        }
+
+        if (OUTPUT_BUFFER_SIZE - used < MAX_LINE_LENGTH + 1) {
+            writeAll(buffer, used);
+            used = 0;
+        }
+        used += format(slot.record, buffer + used, MAX_LINE_LENGTH);
+        buffer[used++] = '\n';
+
+        slot.sequence.store(m_dequeuePos + CAPACITY, std::memory_order_release);
+        m_dequeuePos++;
+        count++;
+    }
+
+    if (OUTPUT_BUFFER_SIZE - used < MAX_LINE_LENGTH + 1) {
+        writeAll(buffer, used);
+        used = 0;
+    }
+    used += reportSuppressed(buffer + used, OUTPUT_BUFFER_SIZE - used,
+                             !m_running.load(std::memory_order_acquire));
+
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        LogRecord notice{};
+        notice.timestampNs = monotonicNs();
+        notice.format = "Logger dropped {} messages (buffer full)";
+        notice.level = LogLevel::Warn;
+        notice.argCount = 1;
+        notice.argTypes[0] = LogRecord::UNSIGNED;
+        notice.args[0].u = dropped - m_reportedDropped;
+        m_reportedDropped = dropped;
+
+        if (OUTPUT_BUFFER_SIZE - used < MAX_LINE_LENGTH + 1) {
+            writeAll(buffer, used);
+            used = 0;
+        }
+        used += format(notice, buffer + used, MAX_LINE_LENGTH);
+        buffer[used++] = '\n';
+    }
+
+    if (used > 0) {
+        writeAll(buffer, used);
+    }
+    m_written.fetch_add(count, std::memory_order_release);
+    return count;
+}
+
+size_t Logger::reportSuppressed(char* out, size_t size, bool force) {
+    const int64_t now = monotonicNs();
+    size_t used = 0;
+
+    for (LogSite* site = m_sites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+        if (size - used < MAX_LINE_LENGTH + 1) {
+            break;  // Remaining sites are picked up on the next drain
+        }
+        if (site->suppressed.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        // Leave counts of still-busy sites for their next accepted message
+        int64_t windowStart = site->windowStartNs.load(std::memory_order_relaxed);
+        if (!force && now - windowStart < LogSite::WINDOW_NS) {
+            continue;
+        }
+        uint32_t count = site->suppressed.exchange(0, std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+
+        LogRecord notice{};
+        notice.timestampNs = now;
+        notice.format = "Suppressed {} messages like: {}";
+        notice.level = LogLevel::Warn;
+        notice.argCount = 1;
+        notice.argTypes[0] = LogRecord::UNSIGNED;
+        notice.args[0].u = count;
+        captureString(notice, site->format, std::strlen(site->format));
+
+        used += format(notice, out + used, MAX_LINE_LENGTH);
+        out[used++] = '\n';
+    }
+    return used;
+}
+
+size_t Logger::format(const LogRecord& record, char* out, size_t size) const {
+    size_t pos = 0;
+
+    // Timestamp: monotonic capture time mapped onto wall-clock time
+    int64_t wallNs = record.timestampNs + m_realtimeOffsetNs;
+    time_t seconds = static_cast<time_t>(wallNs / 1000000000LL);
+    int millis = static_cast<int>((wallNs / 1000000LL) % 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &local);
+    appendf(out, size, pos, "[%s.%03d] [%s] ", timestamp, millis, levelName(record.level));
+
+    // Message: substitute "{}" placeholders in order
+    size_t argIndex = 0;
+    for (const char* p = record.format; *p != '\0' && pos < size - 1; ++p) {
+        if (p[0] == '{' && p[1] == '}' && argIndex < record.argCount) {
+            const LogRecord::Arg& arg = record.args[argIndex];
+            switch (record.argTypes[argIndex]) {
+                case LogRecord::SIGNED:
+                    appendf(out, size, pos, "%" PRId64, arg.i);
+                    break;
+                case LogRecord::UNSIGNED:
+                    appendf(out, size, pos, "%" PRIu64, arg.u);
+                    break;
+                case LogRecord::DOUBLE:
+                    appendf(out, size, pos, "%.4f", arg.d);
+                    break;
+                case LogRecord::STRING:
+                    appendf(out, size, pos, "%.*s", static_cast<int>(arg.s.length),
+                            record.strings + arg.s.offset);
+                    break;
+            }
+            argIndex++;
+            ++p;
+        } else {
+            out[pos++] = *p;
+        }
+    }
+
+    if (record.suppressed > 0) {
+        appendf(out, size, pos, " (suppressed %u similar messages)", record.suppressed);
+    }
+
+    return pos;
+}
+
+void Logger::captureString(LogRecord& record, const char* data, size_t length) noexcept {
+    const size_t available = LogRecord::STRING_BYTES - record.stringBytes;
+    length = std::min(length, available);
+    if (length > 0) {
+        std::memcpy(record.strings + record.stringBytes, data, length);
+    }
+
+    record.argTypes[record.argCount] = LogRecord::STRING;
+    record.args[record.argCount].s.offset = record.stringBytes;
+    record.args[record.argCount].s.length = static_cast<uint16_t>(length);
+    record.argCount++;
+    record.stringBytes = static_cast<uint16_t>(record.stringBytes + length);
+}
@@ -0,0 +1,327 @@
+/**
+ * @file Logger.hpp
+ * @brief Asynchronous, bounded, lock-free structured logger
+ *
+ * Log calls on the sampling thread only capture their arguments into a
+ * fixed-size binary record in a lock-free ring; a background thread
+ * does all formatting and writing to stderr. Memory use is fixed, and
+ * each call site is rate limited, with a count of suppressed messages.
+ */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <time.h>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log message
+ */
+enum class LogLevel : uint8_t {
+    Info,
+    Warn,
+    Error,
+};
+
+/**
+ * @struct LogSite
+ * @brief Per-call-site rate limiting state
+ *
+ * One static instance is created per LOG_* macro expansion. At most
+ * MAX_PER_WINDOW messages per WINDOW_NS are accepted from a site; the
+ * rest are counted and reported with the next accepted message, or by
+ * the writer thread once the site goes quiet.
+ */
+struct LogSite {
+    /// Rate limit window length (1 s)
+    static constexpr int64_t WINDOW_NS = 1000000000LL;
+
+    /// Messages accepted per site per window
+    static constexpr uint32_t MAX_PER_WINDOW = 10;
+
+    std::atomic<int64_t> windowStartNs{0};  ///< Start of current window (monotonic ns)
+    std::atomic<uint32_t> windowCount{0};   ///< Messages accepted in current window
+    std::atomic<uint32_t> suppressed{0};    ///< Messages dropped since last accepted one
+    std::atomic<bool> registered{false};    ///< true once linked into the site list
+    const char* format = nullptr;           ///< Format string (set before registration)
+    LogSite* next = nullptr;                ///< Next registered site
+};
+
+/**
+ * @struct LogRecord
+ * @brief Fixed-size binary log record
+ *
+ * Holds a pointer to the call site's format string (a string literal
+ * using "{}" placeholders) plus the captured argument values. String
+ * arguments are copied into an inline buffer and truncated if needed.
+ */
+struct LogRecord {
+    /// Maximum number of arguments per message
+    static constexpr size_t MAX_ARGS = 6;
+
+    /// Inline storage for copied string arguments
+    static constexpr size_t STRING_BYTES = 128;
+
+    /// Argument type tags
+    enum ArgType : uint8_t { SIGNED, UNSIGNED, DOUBLE, STRING };
+
+    /// One captured argument
+    union Arg {
+        int64_t i;
+        uint64_t u;
+        double d;
+        struct { uint16_t offset; uint16_t length; } s;
+    };
+
+    int64_t timestampNs;            ///< CLOCK_MONOTONIC time of the call
+    const char* format;             ///< Format string literal ("{}" placeholders)
+    uint32_t suppressed;            ///< Messages suppressed at this site before this one
+    LogLevel level;                 ///< Severity
+    uint8_t argCount;               ///< Number of captured arguments
+    uint16_t stringBytes;           ///< Bytes used in strings
+    ArgType argTypes[MAX_ARGS];     ///< Type tag per argument
+    Arg args[MAX_ARGS];             ///< Argument values
+    char strings[STRING_BYTES];     ///< Copied string argument bytes
+};
+
+/**
+ * @class Logger
+ * @brief Process-wide asynchronous logger
+ *
+ * Producers claim a slot in a bounded multi-producer/single-consumer
+ * ring (per-slot sequence numbers, no locks) and fill it in place. If
+ * the ring is full the message is dropped and counted; the writer
+ * thread reports the drop count. The writer sleeps on a condition
+ * variable while the ring is empty; a producer takes the lock only to
+ * wake it. Timestamps are monotonic and converted to wall-clock time
+ * only when formatted, using an offset the writer refreshes every
+ * minute so wall clock steps (e.g. NTP at boot) are followed.
+ *
+ * Use the LOG_INFO / LOG_WARN / LOG_ERROR macros rather than log():
+ * @code
+ *   LOG_INFO("Sent {} samples, last: raw={}", sampleCount, rawValue);
+ *   LOG_ERROR("Request failed: {}", response.error);
+ * @endcode
+ */
+class Logger {
+public:
+    /// Number of records in the ring (power of two)
+    static constexpr size_t CAPACITY = 1024;
+
+    /**
+     * @brief Get the process-wide logger, starting its writer thread on first use
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Destructor - drains pending records and stops the writer thread
+     */
+    ~Logger();
+
+    // Disable copy and move operations (singleton with worker thread)
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Enqueue a message (called via LOG_* macros)
+     * @param site Call-site rate limiting state
+     * @param level Severity
+     * @param format String literal with "{}" placeholders
+     * @param args Up to LogRecord::MAX_ARGS integer, floating-point or string arguments
+     */
+    template <typename... Args>
+    void log(LogSite& site, LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+
+        const int64_t now = monotonicNs();
+        uint32_t suppressed = 0;
+        if (!admit(site, now, suppressed)) {
+            if (!site.registered.load(std::memory_order_relaxed)) {
+                registerSite(site, format);
+            }
+            return;
+        }
+
+        size_t position = 0;
+        Slot* slot = claim(position);
+        if (slot == nullptr) {
+            m_dropped.fetch_add(1 + suppressed, std::memory_order_relaxed);
+            return;
+        }
+
+        LogRecord& record = slot->record;
+        record.timestampNs = now;
+        record.format = format;
+        record.suppressed = suppressed;
+        record.level = level;
+        record.argCount = 0;
+        record.stringBytes = 0;
+        (void)std::initializer_list<int>{(capture(record, args), 0)...};
+        publish(slot, position);
+    }
+
+    /**
+     * @brief Write out all pending records and wait until done
+     */
+    void flush();
+
+    /**
+     * @brief Number of messages dropped because the ring was full
+     */
+    uint64_t dropped() const noexcept;
+
+private:
+    /**
+     * @struct Slot
+     * @brief Ring slot with its sequence number
+     */
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;   ///< Slot state for the lock-free protocol
+        LogRecord record;               ///< Payload
+    };
+
+    Slot* m_slots;                              ///< Ring storage (CAPACITY slots)
+    alignas(64) std::atomic<size_t> m_enqueuePos;   ///< Next position to claim
+    alignas(64) size_t m_dequeuePos;            ///< Next position to read (writer thread only)
+    std::atomic<uint64_t> m_dropped;            ///< Messages dropped (ring full)
+    uint64_t m_reportedDropped;                 ///< Drop count already reported (writer thread only)
+    std::atomic<uint64_t> m_written;            ///< Records written by the writer thread
+    std::atomic<LogSite*> m_sites;              ///< Rate-limited sites (lock-free list)
+    std::atomic<bool> m_running;                ///< Writer thread keeps running while true
+    std::atomic<bool> m_writerIdle;             ///< Writer is (about to be) waiting for a wakeup
+    std::mutex m_wakeMutex;                     ///< Guards waits on the condition variables
+    std::condition_variable m_wake;             ///< Signalled when a record is published
+    std::condition_variable m_drained;          ///< Signalled after the writer has written records
+    int64_t m_realtimeOffsetNs;                 ///< CLOCK_REALTIME - CLOCK_MONOTONIC (writer thread only)
+    int64_t m_realtimeSyncNs;                   ///< Monotonic time of the last offset update
+    std::thread m_writer;                       ///< Background formatting thread
+
+    Logger();
+
+    /**
+     * @brief Current CLOCK_MONOTONIC time in nanoseconds
+     */
+    static int64_t monotonicNs() noexcept {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    /**
+     * @brief Apply per-site rate limit
+     * @param site Call-site state
+     * @param now Current monotonic time
+     * @param suppressed Receives count of messages suppressed before this one
+     * @return true if the message should be logged
+     */
+    static bool admit(LogSite& site, int64_t now, uint32_t& suppressed) noexcept;
+
+    /**
+     * @brief Link a site into the list scanned for stale suppression counts
+     */
+    void registerSite(LogSite& site, const char* format) noexcept;
+
+    /**
+     * @brief Format suppression notices for sites whose window has expired
+     * @return Bytes written to out
+     */
+    size_t reportSuppressed(char* out, size_t size, bool force);
+
+    /**
+     * @brief Claim the next free slot
+     * @param position Receives the claimed ring position
+     * @return Slot to fill, or nullptr if the ring is full
+     */
+    Slot* claim(size_t& position) noexcept;
+
+    /**
+     * @brief Make a filled slot visible to the writer thread
+     */
+    void publish(Slot* slot, size_t position) noexcept;
+
+    /**
+     * @brief Wake the writer thread if it is waiting
+     */
+    void wakeWriter() noexcept;
+
+    /**
+     * @brief Writer thread main loop
+     */
+    void writerLoop();
+
+    /**
+     * @brief true if the next record to write has been published
+     */
+    bool pending() const noexcept;
+
+    /**
+     * @brief Re-read CLOCK_REALTIME - CLOCK_MONOTONIC (follows clock steps)
+     */
+    void syncRealtimeOffset() noexcept;
+
+    /**
+     * @brief Format and write all currently published records
+     * @return Number of records written
+     */
+    size_t drain();
+
+    /**
+     * @brief Format one record as a line (without trailing newline)
+     */
+    size_t format(const LogRecord& record, char* out, size_t size) const;
+
+    // Argument capture overloads
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    capture(LogRecord& record, const T& value) noexcept {
+        record.argTypes[record.argCount] = LogRecord::SIGNED;
+        record.args[record.argCount++].i = static_cast<int64_t>(value);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    capture(LogRecord& record, const T& value) noexcept {
+        record.argTypes[record.argCount] = LogRecord::UNSIGNED;
+        record.args[record.argCount++].u = static_cast<uint64_t>(value);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    capture(LogRecord& record, const T& value) noexcept {
+        record.argTypes[record.argCount] = LogRecord::DOUBLE;
+        record.args[record.argCount++].d = static_cast<double>(value);
+    }
+
+    static void capture(LogRecord& record, const char* value) noexcept {
+        captureString(record, value, value != nullptr ? std::strlen(value) : 0);
+    }
+
+    static void capture(LogRecord& record, const std::string& value) noexcept {
+        captureString(record, value.data(), value.size());
+    }
+
+    static void captureString(LogRecord& record, const char* data, size_t length) noexcept;
+};
+
+/// Log at the given level with per-call-site rate limiting
+#define LOG_AT(level, ...)                                              \
+    do {                                                                \
+        static LogSite logSite_;                                        \
+        Logger::instance().log(logSite_, (level), __VA_ARGS__);         \
+    } while (0)
+
+#define LOG_INFO(...)  LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOGGER_HPP
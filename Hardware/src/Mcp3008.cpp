@@ -14,14 +14,17 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
-#include <devctl.h>
 #include <errno.h>
 #include <cstring>
 #include <stdexcept>
 #include <cstdlib>
 
+#ifdef __QNXNTO__
+#include <devctl.h>
+
 // Include QNX SPI header for proper devctl definitions
 #include <hw/io-spi.h>
+#endif
 
 namespace {
     /// Start bit for MCP3008 command
@@ -80,6 +83,7 @@ void Mcp3008::configureSpi() {
     // and mode are set when the SPI driver is started.
 }
 
+#ifdef __QNXNTO__
 void Mcp3008::spiTransfer(const uint8_t* txBuf, uint8_t* rxBuf, size_t length) {
     // Use QNX devctl for SPI data exchange
     // spi_xchng_t has a flexible array member, so we allocate on stack with union
@@ -112,6 +116,15 @@ void Mcp3008::spiTransfer(const uint8_t* txBuf, uint8_t* rxBuf, size_t length) {
     // Copy RX data from response (data buffer now contains received bytes)
     memcpy(rxBuf, msg->data, length);
 }
+#else
+void Mcp3008::spiTransfer(const uint8_t* txBuf, uint8_t* rxBuf, size_t length) {
+    // Host builds (SIMULATE / REPLAY_FILE on Linux) have no io-spi devctl
+    (void)txBuf;
+    (void)rxBuf;
+    (void)length;
+    throw std::runtime_error("SPI transfer is only supported on QNX");
+}
+#endif
 
 uint16_t Mcp3008::readChannel(uint8_t channel) {
     if (channel > MAX_CHANNEL) {
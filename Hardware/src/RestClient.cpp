@@ -14,17 +14,14 @@ RestClient::RestClient(std::string baseUrl)
     , m_timeout(DEFAULT_TIMEOUT_SECONDS)
     , m_connectTimeout(DEFAULT_CONNECT_TIMEOUT_SECONDS)
 {
-    // Initialize libcurl globally (safe to call multiple times)
-    static bool curlGlobalInit = false;
-    if (!curlGlobalInit) {
-        CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
-        if (res != CURLE_OK) {
-            throw std::runtime_error(
-                std::string("Failed to initialize libcurl: ") + 
-                curl_easy_strerror(res)
-            );
-        }
-        curlGlobalInit = true;
+    // Initialize libcurl globally exactly once (function-local static init
+    // is thread-safe, so clients may be constructed from any thread)
+    static const CURLcode curlGlobalInit = curl_global_init(CURL_GLOBAL_DEFAULT);
+    if (curlGlobalInit != CURLE_OK) {
+        throw std::runtime_error(
+            std::string("Failed to initialize libcurl: ") + 
+            curl_easy_strerror(curlGlobalInit)
+        );
     }
     
     m_curl = curl_easy_init();
@@ -76,7 +73,7 @@ size_t RestClient::writeCallback(char* ptr, size_t size, size_t nmemb, void* use
 }
 
 RestClient::Response RestClient::post(const std::string& endpoint, const std::string& jsonPayload) {
-    Response response{false, 0, "", ""};
+    Response response{false, 0, "", "", 0};
     
     if (!m_curl) {
         response.error = "RestClient not initialized";
@@ -145,11 +142,26 @@ RestClient::Response RestClient::post(const std::string& endpoint, const std::st
     
     // Get HTTP response code
     curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &response.httpCode);
+    response.retryAfterSeconds = retryAfterSeconds(m_curl);
     response.success = true;
     
     return response;
 }
 
+long RestClient::retryAfterSeconds(CURL* curl) {
+#if LIBCURL_VERSION_NUM >= 0x074200
+    // Parsed by libcurl (7.66+) from either delta-seconds or an HTTP date
+    curl_off_t retryAfter = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retryAfter) == CURLE_OK && retryAfter > 0) {
+        // Cap before narrowing: curl_off_t is wider than long on 32-bit targets
+        return retryAfter < RETRY_AFTER_MAX_SECONDS ? static_cast<long>(retryAfter) : RETRY_AFTER_MAX_SECONDS;
+    }
+#else
+    (void)curl;
+#endif
+    return 0;
+}
+
 void RestClient::setTimeout(long timeoutSeconds) {
     m_timeout = timeoutSeconds;
 }
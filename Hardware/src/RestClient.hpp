@@ -17,7 +17,8 @@
  * @brief HTTP client for REST API communication
  * 
  * RAII-based client that initializes libcurl on construction
- * and cleans up on destruction. Thread-safe for single-threaded use.
+ * and cleans up on destruction. Each instance must be used from one thread at a time;
+ * separate instances may be used concurrently.
  * 
  * Example usage:
  * @code
@@ -36,6 +37,9 @@ public:
     /// Default connection timeout in seconds
     static constexpr long DEFAULT_CONNECT_TIMEOUT_SECONDS = 3;
 
+    /// Longest Retry-After honoured, so a bad header cannot silence the device indefinitely
+    static constexpr long RETRY_AFTER_MAX_SECONDS = 3600;
+
     /**
      * @struct Response
      * @brief HTTP response data
@@ -45,6 +49,7 @@ public:
         long httpCode;          ///< HTTP status code (0 if request failed)
         std::string body;       ///< Response body
         std::string error;      ///< Error message if success is false
+        long retryAfterSeconds; ///< Server's Retry-After in seconds (0 if absent, at most RETRY_AFTER_MAX_SECONDS)
     };
 
     /**
@@ -93,6 +98,14 @@ public:
      */
     const std::string& getBaseUrl() const noexcept;
 
+    /**
+     * @brief Read the Retry-After delay from a completed transfer
+     * @param curl Easy handle that has finished its transfer
+     * @return Delay in seconds, capped at RETRY_AFTER_MAX_SECONDS (0 if absent or
+     *         unsupported by this libcurl)
+     */
+    static long retryAfterSeconds(CURL* curl);
+
 private:
     CURL* m_curl;                   ///< libcurl easy handle
     std::string m_baseUrl;          ///< Base URL for requests
@@ -0,0 +1,174 @@
+/**
+ * @file Rollup.cpp
+ * @brief Incremental multi-resolution rollup implementation
+ */
+
+#include "Rollup.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    /// Baseline tracking time constant in milliseconds (several breaths)
+    constexpr double BASELINE_TAU_MS = 5000.0;
+
+    /**
+     * @brief Floor division that rounds toward negative infinity
+     */
+    int64_t floorDiv(int64_t value, int64_t divisor) {
+        int64_t q = value / divisor;
+        if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) {
+            --q;
+        }
+        return q;
+    }
+}
+
+constexpr std::array<uint32_t, RollupAggregator::NUM_RESOLUTIONS> RollupAggregator::RESOLUTIONS_SEC;
+
+RollupAggregator::RollupAggregator(size_t capacity, uint16_t hysteresis)
+    : m_buckets{}
+    , m_ring()
+    , m_head(0)
+    , m_size(0)
+    , m_reserved(0)
+    , m_dropped(0)
+    , m_hysteresis(hysteresis)
+    , m_baseline(0.0)
+    , m_baselineValid(false)
+    , m_lastSampleMs(0)
+    , m_armed(false)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("Rollup capacity must be non-zero");
+    }
+    m_ring.resize(capacity);
+}
+
+void RollupAggregator::addSample(int64_t timestampMs, uint16_t raw) {
+    const bool breath = detectBreath(timestampMs, raw);
+    const int64_t seconds = floorDiv(timestampMs, 1000);
+
+    for (size_t i = 0; i < NUM_RESOLUTIONS; ++i) {
+        Bucket& bucket = m_buckets[i];
+        const int64_t res = RESOLUTIONS_SEC[i];
+        const int64_t start = floorDiv(seconds, res) * res;
+
+        // Any change closes the bucket, so a backward clock step starts new
+        // buckets instead of folding everything into the current one
+        if (bucket.open && start != bucket.start) {
+            closeBucket(i);
+        }
+
+        if (!bucket.open) {
+            bucket.open = true;
+            bucket.start = start;
+            bucket.count = 0;
+            bucket.min = raw;
+            bucket.max = raw;
+            bucket.sum = 0;
+            bucket.breaths = 0;
+        }
+
+        bucket.count++;
+        bucket.min = std::min(bucket.min, raw);
+        bucket.max = std::max(bucket.max, raw);
+        bucket.sum += raw;
+        if (breath) {
+            bucket.breaths++;
+        }
+    }
+}
+
+void RollupAggregator::flush() {
+    for (size_t i = 0; i < NUM_RESOLUTIONS; ++i) {
+        if (m_buckets[i].open) {
+            closeBucket(i);
+        }
+    }
+}
+
+size_t RollupAggregator::reserve(RollupRecord* out, size_t maxRecords) {
+    const size_t n = std::min(maxRecords, m_size);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = m_ring[(m_head + i) % m_ring.size()];
+    }
+    m_reserved = n;
+    return n;
+}
+
+void RollupAggregator::consume(size_t count) {
+    count = std::min(count, m_reserved);
+    m_head = (m_head + count) % m_ring.size();
+    m_size -= count;
+    m_reserved = 0;
+}
+
+void RollupAggregator::release() noexcept {
+    m_reserved = 0;
+}
+
+size_t RollupAggregator::pending() const noexcept {
+    return m_size;
+}
+
+uint64_t RollupAggregator::dropped() const noexcept {
+    return m_dropped;
+}
+
+bool RollupAggregator::detectBreath(int64_t timestampMs, uint16_t raw) {
+    const double value = static_cast<double>(raw);
+    if (!m_baselineValid) {
+        m_baseline = value;
+        m_baselineValid = true;
+        m_lastSampleMs = timestampMs;
+        return false;
+    }
+
+    // Weight by elapsed time so the baseline tracks the same way at any
+    // sample rate; a backward clock step counts as no time passing
+    const double elapsedMs = static_cast<double>(std::max<int64_t>(0, timestampMs - m_lastSampleMs));
+    m_lastSampleMs = timestampMs;
+    m_baseline += (1.0 - std::exp(-elapsedMs / BASELINE_TAU_MS)) * (value - m_baseline);
+
+    if (value < m_baseline - m_hysteresis) {
+        m_armed = true;
+    } else if (m_armed && value > m_baseline + m_hysteresis) {
+        m_armed = false;
+        return true;
+    }
+    return false;
+}
+
+void RollupAggregator::closeBucket(size_t index) {
+    Bucket& bucket = m_buckets[index];
+
+    RollupRecord record;
+    record.resolutionSec = RESOLUTIONS_SEC[index];
+    record.bucketStart = bucket.start;
+    record.count = bucket.count;
+    record.min = bucket.min;
+    record.max = bucket.max;
+    record.mean = static_cast<double>(bucket.sum) / bucket.count;
+    record.breaths = bucket.breaths;
+    push(record);
+
+    bucket.open = false;
+}
+
+void RollupAggregator::push(const RollupRecord& record) {
+    if (m_size == m_ring.size()) {
+        m_dropped++;
+        if (m_reserved == m_size) {
+            return;  // Everything is in flight: the new record is the oldest unsent one left
+        }
+        // Full: drop the oldest record after the in-flight batch, closing the hole
+        for (size_t i = m_reserved; i + 1 < m_size; ++i) {
+            m_ring[(m_head + i) % m_ring.size()] = m_ring[(m_head + i + 1) % m_ring.size()];
+        }
+        m_size--;
+    }
+    m_ring[(m_head + m_size) % m_ring.size()] = record;
+    m_size++;
+}
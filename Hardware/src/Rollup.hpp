@@ -0,0 +1,180 @@
+/**
+ * @file Rollup.hpp
+ * @brief Incremental multi-resolution rollups of the breathing signal
+ *
+ * Maintains min/max/mean/count and breath count per time bucket at
+ * 1 s, 10 s and 60 s resolution. Each sample is folded in with O(1)
+ * work and the aggregator never allocates after construction.
+ */
+
+#ifndef ROLLUP_HPP
+#define ROLLUP_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct RollupRecord
+ * @brief Summary of all samples that fell into one closed time bucket
+ */
+struct RollupRecord {
+    uint32_t resolutionSec;     ///< Bucket width in seconds (1, 10 or 60)
+    int64_t bucketStart;        ///< Bucket start as Unix seconds (aligned to resolution)
+    uint32_t count;             ///< Number of samples in the bucket
+    uint16_t min;               ///< Minimum raw ADC value
+    uint16_t max;               ///< Maximum raw ADC value
+    double mean;                ///< Mean raw ADC value
+    uint32_t breaths;           ///< Breaths whose inhale started in this bucket
+};
+
+/**
+ * @class RollupAggregator
+ * @brief Fixed-memory incremental rollup of raw ADC samples
+ *
+ * Keeps one open bucket per resolution. When a sample lands past the
+ * end of an open bucket, that bucket is closed and appended to an
+ * internal ring of completed records. The uploader takes a batch with
+ * reserve() and then either acknowledges it with consume() or hands it
+ * back with release(). If the ring fills up (e.g. the network is down
+ * for a long time) the oldest records outside the reserved batch are
+ * dropped and counted in dropped(), so an in-flight batch always
+ * matches what consume() removes.
+ *
+ * Breaths are counted with a hysteresis detector around a slowly
+ * tracking baseline: one breath per excursion from below
+ * (baseline - hysteresis) to above (baseline + hysteresis). The
+ * baseline's time constant is in milliseconds, not samples, so counts
+ * do not depend on the polling interval.
+ *
+ * Example usage:
+ * @code
+ *   RollupAggregator rollups;
+ *   rollups.addSample(nowMs, adc.readChannel(0));
+ *   RollupRecord records[16];
+ *   size_t n = rollups.reserve(records, 16);
+ *   if (upload(records, n)) rollups.consume(n); else rollups.release();
+ * @endcode
+ */
+class RollupAggregator {
+public:
+    /// Number of rollup resolutions maintained
+    static constexpr size_t NUM_RESOLUTIONS = 3;
+
+    /// Bucket widths in seconds, finest first
+    static constexpr std::array<uint32_t, NUM_RESOLUTIONS> RESOLUTIONS_SEC = {1, 10, 60};
+
+    /// Default number of completed records retained while awaiting upload
+    static constexpr size_t DEFAULT_CAPACITY = 512;
+
+    /// Default breath detector hysteresis in ADC counts
+    static constexpr uint16_t DEFAULT_HYSTERESIS = 40;
+
+    /**
+     * @brief Construct aggregator with fixed record capacity
+     * @param capacity Maximum completed records held before the oldest is dropped
+     * @param hysteresis Breath detector hysteresis in ADC counts
+     * @throws std::invalid_argument if capacity is 0
+     */
+    explicit RollupAggregator(size_t capacity = DEFAULT_CAPACITY,
+                              uint16_t hysteresis = DEFAULT_HYSTERESIS);
+
+    /**
+     * @brief Fold one sample into all open buckets
+     *
+     * Samples are expected in non-decreasing timestamp order. A sample
+     * from another bucket (including an earlier one after a clock step)
+     * closes the open bucket and starts a new one.
+     *
+     * @param timestampMs Sample time as Unix milliseconds
+     * @param raw Raw ADC value (0-1023)
+     */
+    void addSample(int64_t timestampMs, uint16_t raw);
+
+    /**
+     * @brief Close all open buckets, e.g. on shutdown
+     */
+    void flush();
+
+    /**
+     * @brief Copy the oldest completed records and reserve them for upload
+     *
+     * Reserved records are never dropped when the ring is full. A new
+     * reservation replaces any previous one.
+     *
+     * @param out Destination array
+     * @param maxRecords Capacity of out
+     * @return Number of records copied and reserved
+     */
+    size_t reserve(RollupRecord* out, size_t maxRecords);
+
+    /**
+     * @brief Remove reserved records after their upload finished
+     * @param count Number of records to remove (clamped to the reservation)
+     */
+    void consume(size_t count);
+
+    /**
+     * @brief Return reserved records to the queue for a later retry
+     */
+    void release() noexcept;
+
+    /**
+     * @brief Number of completed records awaiting upload
+     */
+    size_t pending() const noexcept;
+
+    /**
+     * @brief Number of completed records dropped because the ring was full
+     */
+    uint64_t dropped() const noexcept;
+
+private:
+    /**
+     * @struct Bucket
+     * @brief Running state for the open bucket at one resolution
+     */
+    struct Bucket {
+        bool open;              ///< true once a sample has been added
+        int64_t start;          ///< Bucket start as Unix seconds
+        uint32_t count;         ///< Samples so far
+        uint16_t min;           ///< Running minimum
+        uint16_t max;           ///< Running maximum
+        uint64_t sum;           ///< Running sum (for mean)
+        uint32_t breaths;       ///< Breaths so far
+    };
+
+    std::array<Bucket, NUM_RESOLUTIONS> m_buckets;  ///< Open bucket per resolution
+    std::vector<RollupRecord> m_ring;   ///< Completed records (fixed capacity)
+    size_t m_head;                      ///< Index of oldest completed record
+    size_t m_size;                      ///< Number of completed records
+    size_t m_reserved;                  ///< Oldest records currently in flight
+    uint64_t m_dropped;                 ///< Records dropped while full
+
+    uint16_t m_hysteresis;              ///< Breath detector hysteresis (ADC counts)
+    double m_baseline;                  ///< Slowly tracking signal baseline
+    bool m_baselineValid;               ///< false until the first sample
+    int64_t m_lastSampleMs;             ///< Timestamp of the previous sample
+    bool m_armed;                       ///< true after signal dipped below the band
+
+    /**
+     * @brief Update breath detector state
+     * @param timestampMs Sample time as Unix milliseconds
+     * @param raw Raw ADC value
+     * @return true if this sample completes a breath onset
+     */
+    bool detectBreath(int64_t timestampMs, uint16_t raw);
+
+    /**
+     * @brief Close bucket at index and append it to the ring
+     */
+    void closeBucket(size_t index);
+
+    /**
+     * @brief Append a record, dropping the oldest unreserved one if full
+     */
+    void push(const RollupRecord& record);
+};
+
+#endif // ROLLUP_HPP
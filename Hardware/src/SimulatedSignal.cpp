@@ -0,0 +1,46 @@
+/**
+ * @file SimulatedSignal.cpp
+ * @brief Synthetic breathing signal implementation
+ */
+
+#include "SimulatedSignal.hpp"
+
+#include <cmath>
+
+namespace {
+    /// Signal centre in ADC counts
+    constexpr double CENTER_VALUE = 512.0;
+    
+    /// Breathing amplitude in ADC counts
+    constexpr double AMPLITUDE = 300.0;
+    
+    /// Pi (M_PI is not guaranteed under strict feature test macros)
+    constexpr double PI = 3.14159265358979323846;
+}
+
+SimulatedSignal::SimulatedSignal(uint32_t seed, uint32_t startIndex)
+    : m_sampleIndex(startIndex)
+    , m_noiseState(seed != 0 ? seed : 1)
+{
+}
+
+uint16_t SimulatedSignal::next() {
+    // Breathing cycle: ~12-20 breaths per minute = 3-5 second cycle
+    // At 250ms poll interval, one breath cycle = 16 samples (4 seconds)
+    const uint32_t cycleLength = static_cast<uint32_t>(DEFAULT_HALF_CYCLE_SAMPLES * 2);
+    const double phase = (m_sampleIndex++ % cycleLength) / DEFAULT_HALF_CYCLE_SAMPLES;
+    
+    // Small random variation for realism (xorshift32)
+    m_noiseState ^= m_noiseState << 13;
+    m_noiseState ^= m_noiseState >> 17;
+    m_noiseState ^= m_noiseState << 5;
+    double noise = static_cast<double>(m_noiseState % 20) - 10.0;  // +/- 10
+    
+    double value = CENTER_VALUE + AMPLITUDE * std::sin(phase * PI) + noise;
+    
+    // Clamp to valid ADC range
+    if (value < 0) value = 0;
+    if (value > 1023) value = 1023;
+    
+    return static_cast<uint16_t>(value);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file SimulatedSignal.hpp
+ * @brief Synthetic breathing signal source
+ * 
+ * Produces a sine-wave breathing pattern with a little noise so the
+ * pipeline can run without the MCP3008 attached (SIMULATE=1) and so
+ * load tools can emulate many sensors at once.
+ */
+
+#ifndef SIMULATED_SIGNAL_HPP
+#define SIMULATED_SIGNAL_HPP
+
+#include <cstdint>
+
+/**
+ * @class SimulatedSignal
+ * @brief Deterministic per-instance breathing waveform generator
+ * 
+ * Each instance keeps its own sample index and noise state, so
+ * independent instances can be used from different threads.
+ * 
+ * Example usage:
+ * @code
+ *   SimulatedSignal signal;
+ *   uint16_t value = signal.next();
+ * @endcode
+ */
+class SimulatedSignal {
+public:
+    /// Samples per half breath cycle (one breath = 2x this)
+    static constexpr double DEFAULT_HALF_CYCLE_SAMPLES = 8.0;
+
+    /**
+     * @brief Construct signal generator
+     * @param seed Noise seed (vary per instance to decorrelate sensors)
+     * @param startIndex Initial sample index (vary per instance to offset phase)
+     */
+    explicit SimulatedSignal(uint32_t seed = 1, uint32_t startIndex = 0);
+
+    /**
+     * @brief Produce the next sample
+     * @return Simulated ADC value (0-1023)
+     */
+    uint16_t next();
+
+private:
+    uint32_t m_sampleIndex;     ///< Position in the breathing cycle
+    uint32_t m_noiseState;      ///< xorshift32 noise state (never 0)
+};
+
+#endif // SIMULATED_SIGNAL_HPP
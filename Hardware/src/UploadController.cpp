@@ -0,0 +1,228 @@
+/**
+ * @file UploadController.cpp
+ * @brief Adaptive upload pacing implementation
+ */
+
+#include "UploadController.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    /// Batch size after startup and after the circuit closes again
+    constexpr double INITIAL_BATCH = 10.0;
+
+    /// Batch growth per fast response
+    constexpr double BATCH_INCREASE = 5.0;
+
+    /// Multiplicative decrease factor for batch and window
+    constexpr double DECREASE_FACTOR = 0.5;
+
+    /// Responses slower than this count as congestion
+    constexpr int64_t LATENCY_TARGET_MS = 1000;
+
+    /// Smoothed latency weight per sample (as for TCP SRTT)
+    constexpr double LATENCY_ALPHA = 0.125;
+
+    /// Consecutive failures that open the circuit
+    constexpr uint32_t FAILURE_THRESHOLD = 5;
+
+    /// Backoff after the first failure, doubled per consecutive failure
+    constexpr int64_t BACKOFF_BASE_MS = 500;
+
+    /// Longest backoff while the circuit is closed: the one after the last
+    /// failure before it opens (0.5, 1, 2, 4 s; longer waits are the cool-down's job)
+    constexpr int64_t BACKOFF_MAX_MS = BACKOFF_BASE_MS << (FAILURE_THRESHOLD - 2);
+
+    /// First open-circuit cool-down, doubled each time a probe fails
+    constexpr int64_t OPEN_BASE_MS = 30000;
+
+    /// Longest open-circuit cool-down
+    constexpr int64_t OPEN_MAX_MS = 300000;
+}
+
+UploadController::UploadController(size_t maxBatch, size_t maxInFlight, uint32_t seed)
+    : m_maxBatch(maxBatch)
+    , m_maxInFlight(maxInFlight)
+    , m_batch(std::min(INITIAL_BATCH, static_cast<double>(maxBatch)))
+    , m_window(1.0)
+    , m_inFlight(0)
+    , m_srttMs(0.0)
+    , m_lastDecreaseMs(std::numeric_limits<int64_t>::min() / 2)
+    , m_failures(0)
+    , m_retryAtMs(0)
+    , m_state(State::Closed)
+    , m_openUntilMs(0)
+    , m_openDurationMs(OPEN_BASE_MS)
+    , m_probeInFlight(false)
+    , m_rng(seed != 0 ? seed : 1)
+{
+    if (maxBatch == 0 || maxInFlight == 0) {
+        throw std::invalid_argument("UploadController limits must be non-zero");
+    }
+}
+
+UploadController::Outcome UploadController::classify(bool transportOk, long httpCode) noexcept {
+    if (!transportOk) {
+        return Outcome::NetworkError;
+    }
+    if (httpCode >= 200 && httpCode < 300) {
+        return Outcome::Success;
+    }
+    if (httpCode == 429) {
+        return Outcome::Throttled;
+    }
+    if (httpCode >= 500) {
+        return Outcome::ServerError;
+    }
+    return Outcome::Rejected;
+}
+
+bool UploadController::acquire(int64_t nowMs) {
+    if (m_state == State::Open) {
+        if (nowMs < m_openUntilMs) {
+            return false;
+        }
+        m_state = State::HalfOpen;
+    }
+
+    if (m_state == State::HalfOpen) {
+        // Exactly one probe, and only once earlier requests have drained
+        if (m_probeInFlight || m_inFlight > 0) {
+            return false;
+        }
+        m_probeInFlight = true;
+        m_inFlight++;
+        return true;
+    }
+
+    if (nowMs < m_retryAtMs || m_inFlight >= window()) {
+        return false;
+    }
+    m_inFlight++;
+    return true;
+}
+
+void UploadController::complete(Outcome outcome, int64_t latencyMs, int64_t retryAfterMs, int64_t nowMs) {
+    if (m_inFlight > 0) {
+        m_inFlight--;
+    }
+    const bool probe = m_probeInFlight;
+    m_probeInFlight = false;
+
+    if (outcome == Outcome::Success || outcome == Outcome::Rejected) {
+        // Server answered sensibly: the path is healthy even if the payload was not
+        m_srttMs = (m_srttMs == 0.0)
+            ? static_cast<double>(latencyMs)
+            : m_srttMs + LATENCY_ALPHA * (static_cast<double>(latencyMs) - m_srttMs);
+        m_failures = 0;
+        m_retryAtMs = 0;
+
+        if (probe) {
+            // Close and restart slowly rather than resuming the old rate
+            m_state = State::Closed;
+            m_openDurationMs = OPEN_BASE_MS;
+            m_batch = std::min(INITIAL_BATCH, static_cast<double>(m_maxBatch));
+            m_window = 1.0;
+            return;
+        }
+        if (outcome == Outcome::Success) {
+            if (latencyMs > LATENCY_TARGET_MS) {
+                // Fewer concurrent requests; smaller batches would only mean more of them
+                decrease(nowMs, false);
+            } else {
+                increase();
+            }
+        }
+        return;
+    }
+
+    // Throttled, server error or network error
+    m_failures++;
+    decrease(nowMs, true);
+
+    if (m_state == State::Open) {
+        // Late response from before the circuit opened
+        if (retryAfterMs > 0) {
+            m_openUntilMs = std::max(m_openUntilMs, nowMs + retryAfterMs);
+        }
+        return;
+    }
+    if (probe || m_failures >= FAILURE_THRESHOLD) {
+        open(nowMs, retryAfterMs);
+        return;
+    }
+
+    const int64_t backoffMs = std::min(BACKOFF_MAX_MS, BACKOFF_BASE_MS << (m_failures - 1));
+    m_retryAtMs = nowMs + jitter(backoffMs);
+    if (retryAfterMs > 0) {
+        // Never earlier than asked; spread the fleet out a little beyond it
+        m_retryAtMs = std::max(m_retryAtMs, nowMs + retryAfterMs + jitter(retryAfterMs / 10));
+    }
+}
+
+size_t UploadController::batchSize() const noexcept {
+    if (m_state != State::Closed) {
+        return 1;  // Probes stay small
+    }
+    return std::max<size_t>(1, static_cast<size_t>(m_batch));
+}
+
+int64_t UploadController::nextAttemptMs(int64_t nowMs) const noexcept {
+    if (m_state == State::Open) {
+        return std::max(nowMs, m_openUntilMs);
+    }
+    if (m_state == State::HalfOpen) {
+        return nowMs;
+    }
+    return std::max(nowMs, m_retryAtMs);
+}
+
+UploadController::State UploadController::state() const noexcept {
+    return m_state;
+}
+
+size_t UploadController::inFlight() const noexcept {
+    return m_inFlight;
+}
+
+size_t UploadController::window() const noexcept {
+    return std::max<size_t>(1, static_cast<size_t>(m_window));
+}
+
+void UploadController::decrease(int64_t nowMs, bool shrinkBatch) {
+    // Responses to requests sent before the last decrease carry no new information
+    if (nowMs - m_lastDecreaseMs < static_cast<int64_t>(m_srttMs)) {
+        return;
+    }
+    m_lastDecreaseMs = nowMs;
+    if (shrinkBatch) {
+        m_batch = std::max(1.0, m_batch * DECREASE_FACTOR);
+    }
+    m_window = std::max(1.0, m_window * DECREASE_FACTOR);
+}
+
+void UploadController::increase() {
+    m_batch = std::min(static_cast<double>(m_maxBatch), m_batch + BATCH_INCREASE);
+    // Grows by about one slot per window's worth of responses
+    m_window = std::min(static_cast<double>(m_maxInFlight), m_window + 1.0 / m_window);
+}
+
+void UploadController::open(int64_t nowMs, int64_t retryAfterMs) {
+    m_state = State::Open;
+    m_openUntilMs = nowMs + jitter(m_openDurationMs);
+    if (retryAfterMs > 0) {
+        m_openUntilMs = std::max(m_openUntilMs, nowMs + retryAfterMs + jitter(retryAfterMs / 10));
+    }
+    m_openDurationMs = std::min(OPEN_MAX_MS, m_openDurationMs * 2);
+    m_retryAtMs = 0;
+}
+
+int64_t UploadController::jitter(int64_t delayMs) {
+    if (delayMs <= 1) {
+        return delayMs;
+    }
+    std::uniform_int_distribution<int64_t> dist(delayMs / 2, delayMs);
+    return dist(m_rng);
+}
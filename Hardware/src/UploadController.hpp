@@ -0,0 +1,168 @@
+/**
+ * @file UploadController.hpp
+ * @brief Adaptive pacing of uploads to the backend
+ *
+ * Decides when the sensor may send, how many requests may be in flight
+ * and how large each batch should be, based on observed latency and
+ * error responses. Pure policy: it does no I/O and never blocks, so
+ * the event loop asks it before each request and reports back after.
+ */
+
+#ifndef UPLOAD_CONTROLLER_HPP
+#define UPLOAD_CONTROLLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+/**
+ * @class UploadController
+ * @brief AIMD congestion control, jittered backoff and a circuit breaker
+ *
+ * - Congestion window: batch size and in-flight limit grow additively
+ *   while responses are fast. Slow responses halve the in-flight limit;
+ *   429, 5xx and network errors halve both. Decreases happen at most
+ *   once per smoothed round trip.
+ * - Backoff: each consecutive failure doubles the delay before the
+ *   next attempt, with jitter so a fleet does not retry in lockstep.
+ *   A Retry-After from the server is never undercut.
+ * - Circuit breaker: after repeated failures the circuit opens and no
+ *   requests are sent until a jittered cool-down expires. Then a
+ *   single small probe is allowed (half-open); success closes the
+ *   circuit and restarts slowly, failure reopens it for longer.
+ *
+ * All times are CLOCK_MONOTONIC milliseconds supplied by the caller.
+ *
+ * Example usage:
+ * @code
+ *   UploadController uploads(100, 2, seed);
+ *   if (uploads.acquire(nowMs)) {
+ *       send(uploads.batchSize(), [&](Outcome outcome, int64_t latencyMs) {
+ *           uploads.complete(outcome, latencyMs, 0, nowMs());
+ *       });
+ *   } else {
+ *       wakeAt(uploads.nextAttemptMs(nowMs));
+ *   }
+ * @endcode
+ */
+class UploadController {
+public:
+    /**
+     * @enum Outcome
+     * @brief How a request ended, as far as pacing is concerned
+     */
+    enum class Outcome {
+        Success,        ///< 2xx
+        Rejected,       ///< 4xx other than 429 (server healthy, payload bad)
+        Throttled,      ///< 429 Too Many Requests
+        ServerError,    ///< 5xx
+        NetworkError    ///< No HTTP response (connect failure, timeout)
+    };
+
+    /**
+     * @enum State
+     * @brief Circuit breaker state
+     */
+    enum class State {
+        Closed,         ///< Normal operation
+        Open,           ///< Sending suspended until the cool-down expires
+        HalfOpen        ///< One probe request allowed
+    };
+
+    /**
+     * @brief Construct controller
+     * @param maxBatch Largest batch the backend accepts
+     * @param maxInFlight Largest number of concurrent requests
+     * @param seed Jitter seed (should differ between devices)
+     * @throws std::invalid_argument if maxBatch or maxInFlight is 0
+     */
+    UploadController(size_t maxBatch, size_t maxInFlight, uint32_t seed);
+
+    /**
+     * @brief Map a transport result and HTTP status to an Outcome
+     * @param transportOk true if an HTTP response was received
+     * @param httpCode HTTP status code
+     */
+    static Outcome classify(bool transportOk, long httpCode) noexcept;
+
+    /**
+     * @brief Reserve a request slot if sending is allowed now
+     * @param nowMs Current monotonic time in milliseconds
+     * @return true if the caller may start one request (must call complete())
+     */
+    bool acquire(int64_t nowMs);
+
+    /**
+     * @brief Report the end of a request started after acquire()
+     * @param outcome How the request ended
+     * @param latencyMs Time from send to completion in milliseconds
+     * @param retryAfterMs Server's Retry-After in milliseconds (0 if absent; already capped by RestClient)
+     * @param nowMs Current monotonic time in milliseconds
+     */
+    void complete(Outcome outcome, int64_t latencyMs, int64_t retryAfterMs, int64_t nowMs);
+
+    /**
+     * @brief Number of items to put in the next request
+     */
+    size_t batchSize() const noexcept;
+
+    /**
+     * @brief Earliest time acquire() may succeed, ignoring the in-flight limit
+     * @param nowMs Current monotonic time in milliseconds
+     * @return nowMs if not waiting on backoff or an open circuit
+     */
+    int64_t nextAttemptMs(int64_t nowMs) const noexcept;
+
+    /**
+     * @brief Current circuit breaker state
+     */
+    State state() const noexcept;
+
+    /**
+     * @brief Requests currently in flight
+     */
+    size_t inFlight() const noexcept;
+
+    /**
+     * @brief Current in-flight limit
+     */
+    size_t window() const noexcept;
+
+private:
+    size_t m_maxBatch;              ///< Upper bound on batch size
+    size_t m_maxInFlight;           ///< Upper bound on window
+    double m_batch;                 ///< Current batch size (fractional for smooth growth)
+    double m_window;                ///< Current in-flight limit (fractional)
+    size_t m_inFlight;              ///< Requests outstanding
+    double m_srttMs;                ///< Smoothed latency (0 = no sample yet)
+    int64_t m_lastDecreaseMs;       ///< Time of the last multiplicative decrease
+    uint32_t m_failures;            ///< Consecutive failed requests
+    int64_t m_retryAtMs;            ///< No requests before this time (backoff)
+    State m_state;                  ///< Circuit breaker state
+    int64_t m_openUntilMs;          ///< End of the open-circuit cool-down
+    int64_t m_openDurationMs;       ///< Cool-down used for the next opening
+    bool m_probeInFlight;           ///< Half-open probe outstanding
+    std::minstd_rand m_rng;         ///< Jitter source
+
+    /**
+     * @brief Halve window, and optionally batch (at most once per smoothed round trip)
+     */
+    void decrease(int64_t nowMs, bool shrinkBatch);
+
+    /**
+     * @brief Grow batch and window additively
+     */
+    void increase();
+
+    /**
+     * @brief Open the circuit, respecting any Retry-After
+     */
+    void open(int64_t nowMs, int64_t retryAfterMs);
+
+    /**
+     * @brief Random delay in [delayMs / 2, delayMs]
+     */
+    int64_t jitter(int64_t delayMs);
+};
+
+#endif // UPLOAD_CONTROLLER_HPP
@@ -6,15 +6,23 @@
  * an MCP3008 ADC and sending them to a Railway-hosted REST API.
  * 
  * Environment variables:
- *   RAILWAY_API_URL  - Base URL of the REST API (required)
+ *   RAILWAY_API_URL  - Base URL of the REST API (required unless UPLOAD_MODE=none)
  *   SPI_DEVICE       - Path to SPI device (optional, default: /dev/spi0)
  *   POLL_INTERVAL_MS - Polling interval in milliseconds (optional, default: 500)
  *   SIMULATE         - Set to "1" to use simulated breathing data (no hardware needed)
+ *   UPLOAD_MODE      - "raw", "rollup", "both" or "none" (optional, default: both)
+ *                      raw:    POST every sample to /api/v1/breathing/raw
+ *                      rollup: POST only 1 s / 10 s / 60 s summaries to /api/v1/breathing/rollup
+ *                      both:   do both
+ *                      none:   no network I/O (offline replay / profiling)
+ *   CAPTURE_FILE     - Append every sample with its timestamp to this binary file (optional)
+ *   REPLAY_FILE      - Read samples from a capture file instead of the ADC (optional)
+ *   REPLAY_SPEED     - Replay speed factor >= 0.001, 0 = as fast as possible (optional, default: 1)
  * 
  * Exit codes:
  *   0 - Normal termination (via signal)
  *   1 - Configuration error (missing env var)
- *   2 - Hardware initialization error
+ *   2 - Hardware initialization error (ADC, capture or replay file)
  *   3 - Network initialization error
  */
 
@@ -22,18 +30,29 @@
 #define _QNX_SOURCE
 #define _POSIX_C_SOURCE 200809L
 
+#include "AsyncHttpClient.hpp"
+#include "Capture.hpp"
+#include "EventLoop.hpp"
+#include "Logger.hpp"
 #include "Mcp3008.hpp"
 #include "RestClient.hpp"
+#include "Rollup.hpp"
+#include "SimulatedSignal.hpp"
+#include "UploadController.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <csignal>
 #include <unistd.h>
 #include <time.h>
+#include <deque>
 #include <iomanip>
 #include <sstream>
-#include <cmath>
+#include <memory>
+#include <random>
 
 namespace {
     /// Simulation mode flag
@@ -56,10 +75,41 @@ namespace {
     /// API endpoint for posting sensor data
     constexpr const char* API_ENDPOINT = "/api/v1/breathing/raw";
     
-    /// Flag for graceful shutdown
-    volatile sig_atomic_t g_running = 1;
+    /// API endpoint for posting rollup summaries
+    constexpr const char* ROLLUP_ENDPOINT = "/api/v1/breathing/rollup";
+    
+    /// Interval between rollup uploads in milliseconds
+    constexpr int64_t ROLLUP_UPLOAD_INTERVAL_MS = 10000;
+    
+    /// Maximum rollup records sent per request
+    constexpr size_t ROLLUP_UPLOAD_BATCH = 64;
+    
+    /// Maximum raw samples sent per request (well under the backend's 500, so a
+    /// batch is stored long before the request timeout even on a loaded server)
+    constexpr size_t RAW_UPLOAD_BATCH = 100;
+    
+    /// Raw samples held while the network is slow (oldest dropped beyond this)
+    constexpr size_t RAW_PENDING_MAX = 2048;
+    
+    /// Concurrent upload requests (one ordered lane each for raw samples and rollups)
+    constexpr size_t UPLOAD_LANES = 2;
+    
+    /// Longest time shutdown waits for in-flight uploads in milliseconds
+    constexpr int64_t SHUTDOWN_GRACE_MS = 2000;
+    
+    /// Replay samples processed per loop round before yielding to I/O
+    constexpr int REPLAY_BURST = 256;
 }
 
+/**
+ * @struct PendingSample
+ * @brief Raw sample waiting to be uploaded
+ */
+struct PendingSample {
+    uint16_t raw;           ///< Raw ADC value
+    int64_t takenNs;        ///< CLOCK_MONOTONIC time the sample entered the pipeline
+};
+
 /**
  * @brief Convert raw ADC value to voltage
  * @param raw Raw ADC value (0-1023)
@@ -70,24 +120,49 @@ double rawToVoltage(uint16_t raw) {
 }
 
 /**
- * @brief Build JSON payload for API request
+ * @brief Build the JSON object for one raw sample
  * @param raw Raw ADC value
  * @param voltage Calculated voltage
+ * @param ageMs Milliseconds between taking the sample and sending it
  * @return JSON string
  */
-std::string buildJsonPayload(uint16_t raw, double voltage) {
+std::string buildJsonPayload(uint16_t raw, double voltage, int64_t ageMs) {
     std::ostringstream json;
     json << std::fixed << std::setprecision(4);
-    json << "{\"raw\":" << raw << ",\"voltage\":" << voltage << "}";
+    json << "{\"raw\":" << raw << ",\"voltage\":" << voltage << ",\"ageMs\":" << ageMs << "}";
     return json.str();
 }
 
 /**
- * @brief Signal handler for graceful shutdown
+ * @brief Build JSON payload for a batch of rollup records
+ *
+ * Bucket times come from the device clock; sentAt lets the server
+ * refuse them while that clock is not synchronized.
+ *
+ * @param records Completed rollup records
+ * @param count Number of records
+ * @param sentAtMs Current device wall-clock time as Unix milliseconds
+ * @return JSON string
  */
-void signalHandler(int signum) {
-    (void)signum;  // Suppress unused parameter warning
-    g_running = 0;
+std::string buildRollupPayload(const RollupRecord* records, size_t count, int64_t sentAtMs) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(2);
+    json << "{\"sentAt\":" << sentAtMs << ",\"records\":[";
+    for (size_t i = 0; i < count; ++i) {
+        const RollupRecord& r = records[i];
+        if (i > 0) {
+            json << ",";
+        }
+        json << "{\"res\":" << r.resolutionSec
+             << ",\"t\":" << r.bucketStart
+             << ",\"n\":" << r.count
+             << ",\"min\":" << r.min
+             << ",\"max\":" << r.max
+             << ",\"mean\":" << r.mean
+             << ",\"breaths\":" << r.breaths << "}";
+    }
+    json << "]}";
+    return json.str();
 }
 
 /**
@@ -105,165 +180,514 @@ const char* getEnvOrDefault(const char* name, const char* defaultValue) {
 }
 
 /**
- * @brief Log message to stderr with timestamp
+ * @brief Current wall-clock time in Unix microseconds
  */
-void logMessage(const char* level, const std::string& message) {
-    time_t now = time(nullptr);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    std::cerr << "[" << timestamp << "] [" << level << "] " << message << std::endl;
+int64_t currentTimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
 }
 
-void logInfo(const std::string& message) { logMessage("INFO", message); }
-void logError(const std::string& message) { logMessage("ERROR", message); }
-void logWarn(const std::string& message) { logMessage("WARN", message); }
+/**
+ * @brief Random 64-bit id for this boot
+ *
+ * Raw batch ids are deduplicated across all devices, so the prefix must
+ * not collide between units that boot at the same moment.
+ */
+uint64_t randomBootId() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
 
 /**
- * @brief Sleep for specified milliseconds (portable replacement for usleep)
- * @param milliseconds Time to sleep in milliseconds
+ * @brief Current CLOCK_MONOTONIC time in seconds (for elapsed-time reporting)
  */
-void sleepMs(int milliseconds) {
+double monotonicSeconds() {
     struct timespec ts;
-    ts.tv_sec = milliseconds / 1000;
-    ts.tv_nsec = (milliseconds % 1000) * 1000000L;
-    nanosleep(&ts, nullptr);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) + ts.tv_nsec / 1e9;
 }
 
 /**
- * @brief Generate simulated breathing data
- * Produces a realistic sine wave pattern that simulates breathing
- * @return Simulated ADC value (0-1023)
+ * @brief Current CLOCK_MONOTONIC time in milliseconds (for upload pacing)
  */
-uint16_t getSimulatedBreathValue() {
-    static uint32_t sampleIndex = 0;
-    
-    // Breathing cycle: ~12-20 breaths per minute = 3-5 second cycle
-    // At 500ms poll interval, one breath cycle = ~8 samples (4 seconds)
-    const double breathCycleLength = 8.0;  // samples per breath
-    const double phase = (sampleIndex++ % static_cast<uint32_t>(breathCycleLength * 2)) / breathCycleLength;
-    
-    // Sine wave centered at 512 with amplitude of ~300
-    // This simulates the pressure sensor varying with breathing
-    const double centerValue = 512.0;
-    const double amplitude = 300.0;
-    
-    // Add small random variation for realism
-    double noise = (std::rand() % 20) - 10;  // +/- 10
-    
-    double value = centerValue + amplitude * std::sin(phase * M_PI) + noise;
-    
-    // Clamp to valid ADC range
-    if (value < 0) value = 0;
-    if (value > 1023) value = 1023;
-    
-    return static_cast<uint16_t>(value);
+int64_t monotonicMs() {
+    return EventLoop::nowNs() / 1000000;
+}
+
+/**
+ * @brief Build JSON payload for a batch of raw samples
+ *
+ * Each sample carries its age at send time; the server subtracts it
+ * from the receipt time, so device clock error does not matter. The
+ * batch id is the same on every retry, so the server stores a batch
+ * once even if a response is lost.
+ *
+ * @param batchId Identifier of this batch of samples
+ * @param samples Pending samples, oldest first
+ * @param count Number of samples from the front to include
+ * @param nowNs Current CLOCK_MONOTONIC time in nanoseconds
+ * @return JSON string
+ */
+std::string buildRawBatchPayload(const std::string& batchId, const std::deque<PendingSample>& samples,
+                                 size_t count, int64_t nowNs) {
+    std::string json = "{\"batchId\":\"" + batchId + "\",\"samples\":[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            json += ",";
+        }
+        const int64_t ageMs = std::max<int64_t>(0, (nowNs - samples[i].takenNs) / 1000000);
+        json += buildJsonPayload(samples[i].raw, rawToVoltage(samples[i].raw), ageMs);
+    }
+    json += "]}";
+    return json;
 }
 
 int main() {
-    // Setup signal handlers for graceful shutdown
-    std::signal(SIGINT, signalHandler);
-    std::signal(SIGTERM, signalHandler);
-    
-    logInfo("Breath sensor starting...");
+    LOG_INFO("Breath sensor starting...");
     
     // Get configuration from environment
-    const char* apiUrl = getEnvOrDefault("RAILWAY_API_URL", nullptr);
-    if (apiUrl == nullptr) {
-        logError("RAILWAY_API_URL environment variable not set");
-        return 1;
-    }
-    
     const char* spiDevice = getEnvOrDefault("SPI_DEVICE", DEFAULT_SPI_DEVICE);
+    g_simulateMode = std::string(getEnvOrDefault("SIMULATE", "0")) == "1";
     
     const char* pollIntervalStr = getEnvOrDefault("POLL_INTERVAL_MS", nullptr);
     int pollIntervalMs = DEFAULT_POLL_INTERVAL_MS;
     if (pollIntervalStr != nullptr) {
         pollIntervalMs = std::atoi(pollIntervalStr);
         if (pollIntervalMs <= 0) {
-            logWarn("Invalid POLL_INTERVAL_MS, using default");
+            LOG_WARN("Invalid POLL_INTERVAL_MS, using default");
             pollIntervalMs = DEFAULT_POLL_INTERVAL_MS;
         }
     }
     
-    logInfo("Configuration:");
-    logInfo("  API URL: " + std::string(apiUrl));
-    logInfo("  SPI Device: " + std::string(spiDevice));
-    logInfo("  Poll Interval: " + std::to_string(pollIntervalMs) + " ms");
+    const std::string uploadMode = getEnvOrDefault("UPLOAD_MODE", "both");
+    bool uploadRaw = true;
+    bool uploadRollup = true;
+    if (uploadMode == "raw") {
+        uploadRollup = false;
+    } else if (uploadMode == "rollup") {
+        uploadRaw = false;
+    } else if (uploadMode == "none") {
+        uploadRaw = false;
+        uploadRollup = false;
+    } else if (uploadMode != "both") {
+        LOG_WARN("Invalid UPLOAD_MODE, using default (both)");
+    }
+    
+    const char* apiUrl = getEnvOrDefault("RAILWAY_API_URL", nullptr);
+    if (apiUrl == nullptr && (uploadRaw || uploadRollup)) {
+        LOG_ERROR("RAILWAY_API_URL environment variable not set");
+        return 1;
+    }
+    
+    const char* captureFile = getEnvOrDefault("CAPTURE_FILE", nullptr);
+    const char* replayFile = getEnvOrDefault("REPLAY_FILE", nullptr);
+    const char* replaySpeedStr = getEnvOrDefault("REPLAY_SPEED", "1");
+    char* replaySpeedEnd = nullptr;
+    errno = 0;
+    const double replaySpeed = std::strtod(replaySpeedStr, &replaySpeedEnd);
+    if (replaySpeedEnd == replaySpeedStr || *replaySpeedEnd != '\0' || errno == ERANGE ||
+        !std::isfinite(replaySpeed) || replaySpeed < 0 ||
+        (replaySpeed > 0 && replaySpeed < ReplaySource::MIN_SPEED)) {
+        LOG_ERROR("Invalid REPLAY_SPEED '{}': expected 0 or a number >= {}", replaySpeedStr,
+                  ReplaySource::MIN_SPEED);
+        return 1;
+    }
+    
+    LOG_INFO("Configuration:");
+    LOG_INFO("  API URL: {}", apiUrl != nullptr ? apiUrl : "(none)");
+    if (replayFile != nullptr) {
+        LOG_INFO("  Replay File: {} (speed: {})", replayFile, replaySpeed);
+    } else {
+        LOG_INFO("  SPI Device: {}", g_simulateMode ? "(simulated)" : spiDevice);
+        LOG_INFO("  Poll Interval: {} ms", pollIntervalMs);
+    }
+    if (captureFile != nullptr) {
+        LOG_INFO("  Capture File: {}", captureFile);
+    }
+    LOG_INFO("  Upload Raw: {}, Upload Rollups: {}", uploadRaw ? "yes" : "no", uploadRollup ? "yes" : "no");
     
-    // Initialize MCP3008 ADC
+    // Initialize sample source: replay file, simulation or MCP3008 ADC
+    std::unique_ptr<ReplaySource> replay;
     std::unique_ptr<Mcp3008> adc;
-    try {
-        adc = std::make_unique<Mcp3008>(spiDevice);
-        logInfo("MCP3008 ADC initialized on " + std::string(spiDevice));
-    } catch (const std::exception& e) {
-        logError(std::string("Failed to initialize ADC: ") + e.what());
-        return 2;
+    SimulatedSignal simulated;
+    if (replayFile != nullptr) {
+        try {
+            replay = std::make_unique<ReplaySource>(replayFile, replaySpeed);
+            LOG_INFO("Replaying {} records from {}", replay->recordCount(), replayFile);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to open replay file: {}", e.what());
+            return 2;
+        }
+    } else if (g_simulateMode) {
+        LOG_INFO("Simulation mode: using synthetic breathing signal");
+    } else {
+        try {
+            adc = std::make_unique<Mcp3008>(spiDevice);
+            LOG_INFO("MCP3008 ADC initialized on {}", spiDevice);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to initialize ADC: {}", e.what());
+            return 2;
+        }
+    }
+    
+    // Open capture file (appends if it already exists)
+    std::unique_ptr<CaptureWriter> capture;
+    if (captureFile != nullptr) {
+        try {
+            capture = std::make_unique<CaptureWriter>(captureFile);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to open capture file: {}", e.what());
+            return 2;
+        }
     }
     
-    // Initialize REST client
-    std::unique_ptr<RestClient> client;
+    // Event loop drives sampling, uploads and shutdown on this one thread
+    std::unique_ptr<EventLoop> loop;
     try {
-        client = std::make_unique<RestClient>(apiUrl);
-        logInfo("REST client initialized for " + std::string(apiUrl));
+        loop = std::make_unique<EventLoop>();
     } catch (const std::exception& e) {
-        logError(std::string("Failed to initialize REST client: ") + e.what());
-        return 3;
+        LOG_ERROR("Failed to initialize event loop: {}", e.what());
+        return 2;
     }
     
-    logInfo("Starting main loop (poll interval: " + std::to_string(pollIntervalMs) + " ms)");
+    // Initialize non-blocking HTTP client
+    std::unique_ptr<AsyncHttpClient> client;
+    if (uploadRaw || uploadRollup) {
+        try {
+            client = std::make_unique<AsyncHttpClient>(*loop, apiUrl);
+            LOG_INFO("HTTP client initialized for {}", apiUrl);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to initialize HTTP client: {}", e.what());
+            return 3;
+        }
+    }
     
-    // Main polling loop
     uint32_t sampleCount = 0;
-    uint32_t errorCount = 0;
+    uint64_t rawSentCount = 0;
+    uint64_t rawDroppedCount = 0;
+    bool rawInFlight = false;
+    size_t rawBatchCount = 0;
+    uint64_t rawBatchSeq = 0;
+    bool rollupInFlight = false;
+    bool rollupsDue = false;
+    bool shuttingDown = false;
+    int64_t shutdownDeadlineMs = 0;
+    std::deque<PendingSample> rawPending;
+    RollupAggregator rollups;
+    EventLoop::TimerId sampleTimer = 0;
+    EventLoop::TimerId uploadWakeTimer = 0;
+    EventLoop::TimerId rollupTimer = 0;
+    const double loopStart = monotonicSeconds();
     
-    while (g_running) {
-        try {
-            // Read ADC value
-            uint16_t rawValue = adc->readChannel(POT_CHANNEL);
-            double voltage = rawToVoltage(rawValue);
-            
-            // Build and send payload
-            std::string payload = buildJsonPayload(rawValue, voltage);
-            RestClient::Response response = client->post(API_ENDPOINT, payload);
-            
-            sampleCount++;
-            
-            if (response.success) {
-                if (response.httpCode >= 200 && response.httpCode < 300) {
-                    // Success - log every 5 samples
-                    if (sampleCount % 5 == 0) {
-                        logInfo("Sent " + std::to_string(sampleCount) + 
-                               " samples, last: raw=" + std::to_string(rawValue) + 
-                               ", voltage=" + std::to_string(voltage) + "V");
+    // Random per boot: prefixes raw batch ids, which the backend deduplicates
+    // across the whole fleet, and seeds upload jitter
+    const uint64_t bootId = randomBootId();
+    
+    // Paces both upload streams
+    UploadController uploads(RAW_UPLOAD_BATCH, UPLOAD_LANES, static_cast<uint32_t>(bootId ^ (bootId >> 32)));
+    UploadController::State uploadState = UploadController::State::Closed;
+    
+    // Log circuit breaker transitions
+    auto noteUploadState = [&](int64_t now) {
+        const UploadController::State state = uploads.state();
+        if (state == uploadState) {
+            return;
+        }
+        if (state == UploadController::State::Open) {
+            LOG_WARN("Backend unavailable, pausing uploads for {} ms", uploads.nextAttemptMs(now) - now);
+        } else if (state == UploadController::State::HalfOpen) {
+            LOG_INFO("Probing backend");
+        } else {
+            LOG_INFO("Backend recovered, resuming uploads");
+        }
+        uploadState = state;
+    };
+    
+    // Report a finished request to the controller
+    auto finishRequest = [&](const RestClient::Response& response, int64_t startMs) {
+        const UploadController::Outcome outcome = UploadController::classify(response.success, response.httpCode);
+        const int64_t now = monotonicMs();
+        uploads.complete(outcome, now - startMs, static_cast<int64_t>(response.retryAfterSeconds) * 1000, now);
+        noteUploadState(now);
+        return outcome;
+    };
+    
+    // Once shutting down, stop as soon as nothing is left to send
+    auto maybeFinishShutdown = [&] {
+        if (!shuttingDown || rawInFlight || rollupInFlight) {
+            return;
+        }
+        const bool drained = rawPending.empty() && (!uploadRollup || rollups.pending() == 0);
+        // Backoff or an open circuit that outlasts the grace period: give up now
+        if (drained || uploads.nextAttemptMs(monotonicMs()) >= shutdownDeadlineMs) {
+            loop->stop();
+        }
+    };
+    
+    std::function<void()> pumpUploads;
+    
+    // Raw samples: one request in flight keeps them in order; a backlog goes as one batch.
+    // A failed batch is retried unchanged under the same id until the server answers.
+    auto sendRaw = [&](int64_t startMs) {
+        if (rawBatchCount == 0) {
+            rawBatchCount = std::min(rawPending.size(), uploads.batchSize());
+            rawBatchSeq++;
+        }
+        const size_t count = rawBatchCount;
+        std::ostringstream batchId;
+        batchId << std::hex << std::setw(16) << std::setfill('0') << bootId << '-' << std::dec << rawBatchSeq;
+        rawInFlight = true;
+        client->post(API_ENDPOINT, buildRawBatchPayload(batchId.str(), rawPending, count, EventLoop::nowNs()),
+                     [&, count, startMs](const RestClient::Response& response) {
+            rawInFlight = false;
+            switch (finishRequest(response, startMs)) {
+                case UploadController::Outcome::Success: {
+                    const uint16_t last = rawPending[count - 1].raw;
+                    rawPending.erase(rawPending.begin(), rawPending.begin() + count);
+                    rawBatchCount = 0;
+                    // Log roughly every 5 samples
+                    if (rawSentCount / 5 != (rawSentCount + count) / 5) {
+                        LOG_INFO("Sent {} samples, last: raw={}, voltage={}V",
+                                 rawSentCount + count, last, rawToVoltage(last));
                     }
-                } else {
-                    // HTTP error
-                    logWarn("HTTP " + std::to_string(response.httpCode) + 
-                           " for sample " + std::to_string(sampleCount));
+                    rawSentCount += count;
+                    break;
                 }
+                case UploadController::Outcome::Rejected:
+                    // Rejected payload will never be accepted - drop it rather than retry forever
+                    LOG_WARN("HTTP {} for {} samples, discarding", response.httpCode, count);
+                    rawPending.erase(rawPending.begin(), rawPending.begin() + count);
+                    rawBatchCount = 0;
+                    break;
+                case UploadController::Outcome::Throttled:
+                case UploadController::Outcome::ServerError:
+                    LOG_WARN("HTTP {} for {} samples, will retry", response.httpCode, count);
+                    break;
+                case UploadController::Outcome::NetworkError:
+                    LOG_ERROR("Request failed: {}", response.error);
+                    break;
+            }
+            pumpUploads();
+            maybeFinishShutdown();
+        });
+    };
+    
+    // Rollups: upload pending records in batches, one request at a time
+    auto sendRollups = [&](int64_t startMs) {
+        RollupRecord batch[ROLLUP_UPLOAD_BATCH];
+        const size_t count = rollups.reserve(batch, std::min(ROLLUP_UPLOAD_BATCH, uploads.batchSize()));
+        rollupInFlight = true;
+        client->post(ROLLUP_ENDPOINT, buildRollupPayload(batch, count, currentTimeUs() / 1000),
+                     [&, count, startMs](const RestClient::Response& response) {
+            rollupInFlight = false;
+            switch (finishRequest(response, startMs)) {
+                case UploadController::Outcome::Success:
+                    rollups.consume(count);
+                    break;
+                case UploadController::Outcome::Rejected:
+                    // Rejected payload will never be accepted - drop it rather than retry forever
+                    LOG_WARN("HTTP {} for rollup upload, discarding {} records", response.httpCode, count);
+                    rollups.consume(count);
+                    break;
+                case UploadController::Outcome::Throttled:
+                case UploadController::Outcome::ServerError:
+                    LOG_WARN("HTTP {} for rollup upload, will retry", response.httpCode);
+                    rollups.release();
+                    break;
+                case UploadController::Outcome::NetworkError:
+                    LOG_ERROR("Rollup upload failed: {}", response.error);
+                    rollups.release();
+                    break;
+            }
+            if (rollups.pending() == 0) {
+                rollupsDue = false;
+            }
+            pumpUploads();
+            maybeFinishShutdown();
+        });
+    };
+    
+    // Start whatever the controller allows; never waits, so sampling is never delayed
+    pumpUploads = [&] {
+        if (!client) {
+            return;
+        }
+        const int64_t now = monotonicMs();
+        const bool rawWaiting = uploadRaw && !rawInFlight && !rawPending.empty();
+        const bool rollupWaiting = uploadRollup && rollupsDue && !rollupInFlight && rollups.pending() > 0;
+        bool blocked = false;
+        if (rawWaiting) {
+            if (uploads.acquire(now)) {
+                noteUploadState(now);
+                sendRaw(now);
+            } else {
+                blocked = true;
+            }
+        }
+        if (rollupWaiting) {
+            if (uploads.acquire(now)) {
+                noteUploadState(now);
+                sendRollups(now);
             } else {
-                // Request failed
-                errorCount++;
-                logError("Request failed: " + response.error);
-                
-                // If too many consecutive errors, slow down
-                if (errorCount > 10) {
-                    logWarn("Multiple errors, backing off...");
-                    sleepMs(5000);  // 5 second backoff
-                    errorCount = 0;
+                blocked = true;
+            }
+        }
+        // Held back by backoff or an open circuit: wake when it expires
+        // (with requests in flight, their completion pumps again instead)
+        if (blocked && uploads.inFlight() == 0 && uploadWakeTimer == 0) {
+            uploadWakeTimer = loop->addTimerAt(uploads.nextAttemptMs(now) * 1000000LL, [&] {
+                uploadWakeTimer = 0;
+                pumpUploads();
+            });
+        }
+    };
+    
+    // Process one sample: capture, rollups, raw upload queue
+    auto handleSample = [&](int64_t nowUs, uint16_t rawValue) {
+        int64_t nowMs = nowUs / 1000;
+        sampleCount++;
+        
+        if (uploadRollup) {
+            rollups.addSample(nowMs, rawValue);
+            // A full batch goes early (fast replay, catching up); otherwise rollupTimer paces uploads
+            if (rollups.pending() >= ROLLUP_UPLOAD_BATCH) {
+                rollupsDue = true;
+            }
+        }
+        
+        if (uploadRaw) {
+            if (rawPending.size() == RAW_PENDING_MAX) {
+                // Drop the oldest sample that is not part of the current batch (in flight or
+                // awaiting retry), so a retry carries exactly what its batch id stands for
+                rawPending.erase(rawPending.begin() + static_cast<std::ptrdiff_t>(rawBatchCount));
+                rawDroppedCount++;
+            }
+            rawPending.push_back(PendingSample{rawValue, EventLoop::nowNs()});
+        }
+        pumpUploads();
+    };
+    
+    // Graceful shutdown: stop sampling, flush what we have, give uploads a bounded grace period
+    auto beginShutdown = [&] {
+        if (shuttingDown) {
+            return;
+        }
+        shuttingDown = true;
+        shutdownDeadlineMs = monotonicMs() + SHUTDOWN_GRACE_MS;
+        if (sampleTimer != 0) {
+            loop->cancelTimer(sampleTimer);
+            sampleTimer = 0;
+        }
+        if (rollupTimer != 0) {
+            loop->cancelTimer(rollupTimer);
+            rollupTimer = 0;
+        }
+        if (uploadRollup) {
+            rollups.flush();
+            rollupsDue = true;
+        }
+        pumpUploads();
+        loop->addTimer(SHUTDOWN_GRACE_MS, [&] {
+            LOG_WARN("Uploads still pending after {} ms, exiting anyway", SHUTDOWN_GRACE_MS);
+            loop->stop();
+        });
+        maybeFinishShutdown();
+    };
+    
+    loop->watchSignal(SIGINT, beginShutdown);
+    loop->watchSignal(SIGTERM, beginShutdown);
+    
+    // Rollup uploads run on the monotonic clock, so wall clock steps cannot stall them
+    if (uploadRollup) {
+        rollupTimer = loop->addTimer(ROLLUP_UPLOAD_INTERVAL_MS, [&] {
+            rollupsDue = true;
+            pumpUploads();
+        }, ROLLUP_UPLOAD_INTERVAL_MS);
+    }
+    
+    // Paced replay sleeps on the loop until each sample is due; unpaced runs in bursts
+    CaptureSample nextSample;
+    int64_t nextDueNs = 0;
+    bool haveSample = false;
+    std::function<void()> replayTick;
+    
+    if (replay) {
+        LOG_INFO("Starting main loop (replay)");
+        
+        haveSample = replay->read(nextSample, nextDueNs);
+        replayTick = [&] {
+            sampleTimer = 0;
+            for (int burst = 0; burst < REPLAY_BURST; ++burst) {
+                if (!haveSample) {
+                    LOG_INFO("Replay finished");
+                    beginShutdown();
+                    return;
+                }
+                if (nextDueNs > EventLoop::nowNs()) {
+                    sampleTimer = loop->addTimerAt(nextDueNs, replayTick);
+                    return;
                 }
+                handleSample(nextSample.timestampUs, nextSample.raw);
+                haveSample = replay->read(nextSample, nextDueNs);
             }
-            
+            sampleTimer = loop->addTimer(0, replayTick);  // Yield so uploads make progress
+        };
+        sampleTimer = loop->addTimer(0, replayTick);
+    } else {
+        LOG_INFO("Starting main loop (poll interval: {} ms)", pollIntervalMs);
+        
+        sampleTimer = loop->addTimer(0, [&] {
+            try {
+                uint16_t rawValue = g_simulateMode ? simulated.next() : adc->readChannel(POT_CHANNEL);
+                int64_t nowUs = currentTimeUs();
+                if (capture) {
+                    // Recording is best effort; it must never cost live samples
+                    try {
+                        capture->append(EventLoop::nowNs() / 1000, POT_CHANNEL, rawValue);
+                    } catch (const std::exception& e) {
+                        LOG_ERROR("Capture failed after {} samples, recording disabled: {}",
+                                  capture->sampleCount(), e.what());
+                        capture.reset();
+                    }
+                }
+                handleSample(nowUs, rawValue);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error in main loop: {}", e.what());
+            }
+        }, pollIntervalMs);
+    }
+    
+    try {
+        loop->run();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Event loop failed: {}", e.what());
+    }
+    
+    if (replay) {
+        const double elapsed = monotonicSeconds() - loopStart;
+        LOG_INFO("Replayed {} samples in {} s ({} samples/s)",
+                 sampleCount, elapsed, elapsed > 0 ? sampleCount / elapsed : 0.0);
+    }
+    if (capture) {
+        try {
+            capture->flush();
+            LOG_INFO("Captured {} samples to {}", capture->sampleCount(), captureFile);
         } catch (const std::exception& e) {
-            errorCount++;
-            logError(std::string("Error in main loop: ") + e.what());
+            LOG_ERROR("Failed to flush capture file: {}", e.what());
         }
-        
-        // Sleep until next poll
-        sleepMs(pollIntervalMs);
     }
     
-    logInfo("Shutting down after " + std::to_string(sampleCount) + " samples");
+    if (rawDroppedCount > 0 || !rawPending.empty()) {
+        LOG_WARN("Raw samples not uploaded: {} dropped (backlog full), {} unsent at exit",
+                 rawDroppedCount, rawPending.size());
+    }
+    if (uploadRollup && (rollups.dropped() > 0 || rollups.pending() > 0)) {
+        LOG_WARN("Rollup records not uploaded: {} dropped (buffer full), {} unsent at exit",
+                 rollups.dropped(), rollups.pending());
+    }
+    
+    LOG_INFO("Shutting down after {} samples", sampleCount);
     
     return 0;
 }
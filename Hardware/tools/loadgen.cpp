@@ -0,0 +1,484 @@
+/**
+ * @file loadgen.cpp
+ * @brief Fleet load generator for the raw-ingest API
+ *
+ * Emulates many virtual breath sensors posting to /api/v1/breathing/raw
+ * using the same RestClient and SimulatedSignal as the device. Runs on a
+ * Linux host against a locally started backend (see `make loadgen`).
+ *
+ * Each worker thread owns one RestClient (one keep-alive connection) and
+ * a disjoint slice of the virtual sensors, scheduled on a min-heap by
+ * next due time. Scheduling is open-loop: a sensor's next send time does
+ * not move when the backend is slow, and latency is measured from the
+ * intended send time so queueing delay is not hidden (coordinated
+ * omission). Service time (request start to response) is reported too.
+ *
+ * Usage:
+ *   breath_loadgen [options]
+ *     --url=URL            Backend base URL (default: $RAILWAY_API_URL or http://localhost:3000)
+ *     --sensors=N          Virtual sensors (default: 1000)
+ *     --rate=HZ            Samples per second per sensor (default: 4)
+ *     --mode=single|batch  One sample per request, or batched (default: single)
+ *     --batch-size=K       Samples per request in batch mode, 1-500 (default: 20)
+ *     --connections=C      Concurrent connections / worker threads (default: 32)
+ *     --duration=S         Test duration in seconds (default: 30)
+ *
+ * Exit codes:
+ *   0 - Run completed
+ *   1 - Invalid arguments
+ *   3 - Network initialization error
+ */
+
+#include "../src/RestClient.hpp"
+#include "../src/SimulatedSignal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /// Reference voltage for ADC (matches the device)
+    constexpr double VREF = 3.3;
+
+    /// Maximum ADC value (10-bit)
+    constexpr double ADC_MAX = 1023.0;
+
+    /// API endpoint under test
+    constexpr const char* API_ENDPOINT = "/api/v1/breathing/raw";
+
+    /// Largest batch POST /api/v1/breathing/raw accepts
+    constexpr uint32_t MAX_BATCH_SIZE = 500;
+
+    /// Default backend URL for a locally started server
+    constexpr const char* DEFAULT_URL = "http://localhost:3000";
+
+    /// Interval between progress lines
+    constexpr auto PROGRESS_INTERVAL = std::chrono::seconds(1);
+
+    /// Flag for early stop (Ctrl-C)
+    volatile sig_atomic_t g_running = 1;
+
+    /**
+     * @struct Options
+     * @brief Command-line configuration
+     */
+    struct Options {
+        std::string url;
+        uint32_t sensors = 1000;
+        double rateHz = 4.0;
+        bool batchMode = false;
+        uint32_t batchSize = 20;
+        uint32_t connections = 32;
+        uint32_t durationSec = 30;
+    };
+
+    /**
+     * @class LatencyHistogram
+     * @brief Fixed-size log-linear histogram of microsecond latencies
+     *
+     * Values below 128 us are recorded exactly; above that each power
+     * of two is split into 64 sub-buckets (< 1.6% relative error).
+     * Recording is O(1) and allocation-free.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr uint32_t SUB_BUCKETS = 64;
+        static constexpr uint32_t LINEAR_LIMIT = 2 * SUB_BUCKETS;
+        static constexpr uint32_t MAX_EXPONENT = 32;
+        static constexpr size_t NUM_BUCKETS = LINEAR_LIMIT + MAX_EXPONENT * SUB_BUCKETS;
+
+        LatencyHistogram() : m_counts{}, m_total(0), m_max(0) {}
+
+        void record(uint64_t micros) {
+            m_counts[indexFor(micros)]++;
+            m_total++;
+            m_max = std::max(m_max, micros);
+        }
+
+        void merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+                m_counts[i] += other.m_counts[i];
+            }
+            m_total += other.m_total;
+            m_max = std::max(m_max, other.m_max);
+        }
+
+        /**
+         * @brief Value at the given percentile (upper bound of its bucket)
+         * @param percentile 0-100
+         */
+        uint64_t percentile(double percentile) const {
+            if (m_total == 0) {
+                return 0;
+            }
+            uint64_t target = static_cast<uint64_t>(percentile / 100.0 * m_total + 0.5);
+            target = std::max<uint64_t>(1, std::min(target, m_total));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+                seen += m_counts[i];
+                if (seen >= target) {
+                    return std::min(upperBound(i), m_max);
+                }
+            }
+            return m_max;
+        }
+
+        uint64_t total() const noexcept { return m_total; }
+        uint64_t max() const noexcept { return m_max; }
+
+    private:
+        std::array<uint64_t, NUM_BUCKETS> m_counts;
+        uint64_t m_total;
+        uint64_t m_max;
+
+        static size_t indexFor(uint64_t v) {
+            if (v < LINEAR_LIMIT) {
+                return static_cast<size_t>(v);
+            }
+            // Highest set bit >= 7; shift so the top 7 bits remain (64..127)
+            uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(v));
+            uint32_t shift = msb - 6;
+            if (shift > MAX_EXPONENT) {
+                return NUM_BUCKETS - 1;
+            }
+            uint64_t sub = (v >> shift) - SUB_BUCKETS;
+            return LINEAR_LIMIT + (shift - 1) * SUB_BUCKETS + static_cast<size_t>(sub);
+        }
+
+        static uint64_t upperBound(size_t index) {
+            if (index < LINEAR_LIMIT) {
+                return index;
+            }
+            size_t rel = index - LINEAR_LIMIT;
+            uint32_t shift = static_cast<uint32_t>(rel / SUB_BUCKETS) + 1;
+            uint64_t sub = rel % SUB_BUCKETS + SUB_BUCKETS;
+            return ((sub + 1) << shift) - 1;
+        }
+    };
+
+    /**
+     * @struct WorkerStats
+     * @brief Per-worker counters, merged after the run
+     */
+    struct WorkerStats {
+        LatencyHistogram responseTime;  ///< Intended send time -> response
+        LatencyHistogram serviceTime;   ///< Actual send time -> response
+        uint64_t samples = 0;           ///< Samples carried by 2xx responses
+        uint64_t ok = 0;                ///< 2xx responses
+        uint64_t clientErrors = 0;      ///< 4xx responses
+        uint64_t serverErrors = 0;      ///< 5xx (and other non-2xx) responses
+        uint64_t transportErrors = 0;   ///< Connection failures / timeouts
+    };
+
+    /// Live counters for progress output (relaxed; informational only)
+    std::atomic<uint64_t> g_liveRequests{0};
+    std::atomic<uint64_t> g_liveErrors{0};
+
+    /**
+     * @struct VirtualSensor
+     * @brief One emulated device
+     */
+    struct VirtualSensor {
+        Clock::time_point nextDue;  ///< Intended time of next request
+        SimulatedSignal signal;     ///< Independent waveform
+    };
+
+    /// Heap entry: due time and index into the worker's sensor list
+    using DueEntry = std::pair<Clock::time_point, size_t>;
+}
+
+/**
+ * @brief Signal handler for early stop
+ */
+void signalHandler(int signum) {
+    (void)signum;
+    g_running = 0;
+}
+
+/**
+ * @brief Build JSON payload for one or more samples
+ * @param sensor Sensor to draw samples from
+ * @param count Number of samples (1 = single-sample format)
+ * @param batch true to use the { "samples": [...] } format
+ * @param sampleIntervalMs Spacing of the samples, for their "ageMs" (oldest first)
+ */
+std::string buildPayload(VirtualSensor& sensor, uint32_t count, bool batch, int64_t sampleIntervalMs) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    if (batch) {
+        json << "{\"samples\":[";
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint16_t raw = sensor.signal.next();
+        double voltage = (static_cast<double>(raw) / ADC_MAX) * VREF;
+        if (i > 0) {
+            json << ",";
+        }
+        json << "{\"raw\":" << raw << ",\"voltage\":" << voltage
+             << ",\"ageMs\":" << static_cast<int64_t>(count - 1 - i) * sampleIntervalMs << "}";
+    }
+    if (batch) {
+        json << "]}";
+    }
+    return json.str();
+}
+
+/**
+ * @brief Drive one worker's slice of sensors until the deadline
+ */
+void runWorker(RestClient& client,
+               std::vector<VirtualSensor>& sensors,
+               Clock::duration period,
+               uint32_t samplesPerRequest,
+               bool batch,
+               Clock::time_point deadline,
+               WorkerStats& stats) {
+    const int64_t sampleIntervalMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(period).count() / samplesPerRequest;
+    std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<DueEntry>> due;
+    for (size_t i = 0; i < sensors.size(); ++i) {
+        due.emplace(sensors[i].nextDue, i);
+    }
+
+    while (g_running && !due.empty()) {
+        DueEntry entry = due.top();
+        if (entry.first >= deadline) {
+            break;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (entry.first > now) {
+            // Sleep in short slices so Ctrl-C stays responsive
+            std::this_thread::sleep_for(std::min<Clock::duration>(entry.first - now,
+                                                                  std::chrono::milliseconds(100)));
+            continue;
+        }
+        due.pop();
+
+        VirtualSensor& sensor = sensors[entry.second];
+        std::string payload = buildPayload(sensor, samplesPerRequest, batch, sampleIntervalMs);
+
+        Clock::time_point sendTime = Clock::now();
+        RestClient::Response response = client.post(API_ENDPOINT, payload);
+        Clock::time_point doneTime = Clock::now();
+
+        auto micros = [](Clock::duration d) {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+        };
+        stats.responseTime.record(micros(doneTime - entry.first));
+        stats.serviceTime.record(micros(doneTime - sendTime));
+        g_liveRequests.fetch_add(1, std::memory_order_relaxed);
+
+        if (!response.success) {
+            stats.transportErrors++;
+            g_liveErrors.fetch_add(1, std::memory_order_relaxed);
+        } else if (response.httpCode >= 200 && response.httpCode < 300) {
+            stats.ok++;
+            stats.samples += samplesPerRequest;
+        } else {
+            if (response.httpCode >= 400 && response.httpCode < 500) {
+                stats.clientErrors++;
+            } else {
+                stats.serverErrors++;
+            }
+            g_liveErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Open-loop schedule: next send is relative to the intended time
+        sensor.nextDue = entry.first + period;
+        due.emplace(sensor.nextDue, entry.second);
+    }
+}
+
+/**
+ * @brief Parse an unsigned option value, rejecting zero and garbage
+ */
+bool parsePositive(const std::string& text, uint32_t& out) {
+    char* end = nullptr;
+    unsigned long value = std::strtoul(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || value == 0) {
+        return false;
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+/**
+ * @brief Parse command-line options
+ * @return false on invalid input (message already printed)
+ */
+bool parseOptions(int argc, char* argv[], Options& options) {
+    const char* envUrl = std::getenv("RAILWAY_API_URL");
+    options.url = (envUrl != nullptr && envUrl[0] != '\0') ? envUrl : DEFAULT_URL;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+        bool ok = true;
+
+        if (key == "--url") {
+            options.url = value;
+            ok = !value.empty();
+        } else if (key == "--sensors") {
+            ok = parsePositive(value, options.sensors);
+        } else if (key == "--rate") {
+            char* end = nullptr;
+            options.rateHz = std::strtod(value.c_str(), &end);
+            ok = end != value.c_str() && *end == '\0' && options.rateHz > 0;
+        } else if (key == "--mode") {
+            ok = value == "single" || value == "batch";
+            options.batchMode = value == "batch";
+        } else if (key == "--batch-size") {
+            ok = parsePositive(value, options.batchSize) && options.batchSize <= MAX_BATCH_SIZE;
+        } else if (key == "--connections") {
+            ok = parsePositive(value, options.connections);
+        } else if (key == "--duration") {
+            ok = parsePositive(value, options.durationSec);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Invalid argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Print one latency summary line
+ */
+void printLatency(const char* label, const LatencyHistogram& histogram) {
+    auto ms = [](uint64_t micros) { return static_cast<double>(micros) / 1000.0; };
+    std::cout << std::fixed << std::setprecision(2)
+              << "  " << std::left << std::setw(15) << label << std::right
+              << " p50=" << ms(histogram.percentile(50)) << "ms"
+              << " p90=" << ms(histogram.percentile(90)) << "ms"
+              << " p99=" << ms(histogram.percentile(99)) << "ms"
+              << " p99.9=" << ms(histogram.percentile(99.9)) << "ms"
+              << " max=" << ms(histogram.max()) << "ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    const uint32_t samplesPerRequest = options.batchMode ? options.batchSize : 1;
+    const uint32_t workers = std::min(options.connections, options.sensors);
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(samplesPerRequest / options.rateHz));
+    const double targetRps = options.sensors * options.rateHz / samplesPerRequest;
+
+    std::cout << "Load test: " << options.url << API_ENDPOINT << std::endl
+              << "  sensors=" << options.sensors
+              << " rate=" << options.rateHz << "Hz"
+              << " mode=" << (options.batchMode ? "batch" : "single")
+              << " samples/request=" << samplesPerRequest
+              << " connections=" << workers
+              << " duration=" << options.durationSec << "s" << std::endl
+              << "  target=" << std::fixed << std::setprecision(1) << targetRps << " req/s" << std::endl;
+
+    // Create clients up front so connection setup errors surface early
+    std::vector<std::unique_ptr<RestClient>> clients;
+    try {
+        for (uint32_t w = 0; w < workers; ++w) {
+            clients.push_back(std::make_unique<RestClient>(options.url));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to initialize REST client: " << e.what() << std::endl;
+        return 3;
+    }
+
+    // Spread sensors round-robin over workers, staggering start times
+    // uniformly across one period so requests do not arrive in lockstep
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::seconds(options.durationSec);
+    std::vector<std::vector<VirtualSensor>> slices(workers);
+    for (uint32_t s = 0; s < options.sensors; ++s) {
+        Clock::time_point firstDue = start + period * s / options.sensors;
+        slices[s % workers].push_back(VirtualSensor{firstDue, SimulatedSignal(s + 1, s * 7)});
+    }
+
+    std::vector<WorkerStats> stats(workers);
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (uint32_t w = 0; w < workers; ++w) {
+        threads.emplace_back(runWorker, std::ref(*clients[w]), std::ref(slices[w]), period,
+                             samplesPerRequest, options.batchMode, deadline, std::ref(stats[w]));
+    }
+
+    // Progress output while the run is active
+    uint64_t lastRequests = 0;
+    uint64_t lastErrors = 0;
+    Clock::time_point nextProgress = start + PROGRESS_INTERVAL;
+    while (g_running && Clock::now() < deadline) {
+        std::this_thread::sleep_until(std::min(nextProgress, deadline));
+        if (Clock::now() >= nextProgress) {
+            uint64_t requests = g_liveRequests.load(std::memory_order_relaxed);
+            uint64_t errors = g_liveErrors.load(std::memory_order_relaxed);
+            std::cout << "  [" << std::chrono::duration_cast<std::chrono::seconds>(nextProgress - start).count()
+                      << "s] " << (requests - lastRequests) << " req/s, "
+                      << (errors - lastErrors) << " errors/s" << std::endl;
+            lastRequests = requests;
+            lastErrors = errors;
+            nextProgress += PROGRESS_INTERVAL;
+        }
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    WorkerStats total;
+    for (const WorkerStats& s : stats) {
+        total.responseTime.merge(s.responseTime);
+        total.serviceTime.merge(s.serviceTime);
+        total.samples += s.samples;
+        total.ok += s.ok;
+        total.clientErrors += s.clientErrors;
+        total.serverErrors += s.serverErrors;
+        total.transportErrors += s.transportErrors;
+    }
+
+    const uint64_t requests = total.responseTime.total();
+    const uint64_t failed = requests - total.ok;
+    std::cout << std::endl << "Results (" << std::fixed << std::setprecision(1) << elapsedSec << "s):" << std::endl
+              << "  requests=" << requests
+              << " ok=" << total.ok
+              << " 4xx=" << total.clientErrors
+              << " 5xx/other=" << total.serverErrors
+              << " transport=" << total.transportErrors << std::endl
+              << "  throughput=" << requests / elapsedSec << " req/s, "
+              << total.samples / elapsedSec << " samples/s"
+              << " (target " << targetRps << " req/s)" << std::endl
+              << "  error rate=" << std::setprecision(2)
+              << (requests > 0 ? 100.0 * failed / requests : 0.0) << "%" << std::endl;
+    printLatency("response time", total.responseTime);
+    printLatency("service time", total.serviceTime);
+
+    return 0;
+}
@@ -42,6 +42,15 @@ export const config = {
     minBreathingRate: parseInt(process.env.MIN_BREATHING_RATE || '4', 10),
   },
   
+  // Retention
+  retention: {
+    /** How long raw batch ids are remembered for retry deduplication (ms) */
+    rawBatchMs: parseInt(process.env.RAW_BATCH_RETENTION_MS || '604800000', 10),
+    
+    /** Interval between retention runs (ms) */
+    pruneIntervalMs: parseInt(process.env.RETENTION_PRUNE_INTERVAL_MS || '3600000', 10),
+  },
+  
   // API
   api: {
     /** API version prefix */
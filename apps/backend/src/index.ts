@@ -1,7 +1,7 @@
 import { createServer } from 'http';
 import { createApp } from './app';
 import { config, validateConfig } from './config';
-import { initDatabase, closeDatabase, initSchema } from './storage';
+import { initDatabase, closeDatabase, initSchema, startRetention, stopRetention } from './storage';
 import { wsServer } from './websocket';
 import { logger } from './utils/logger';
 
@@ -31,6 +31,9 @@ async function main(): Promise<void> {
     process.exit(1);
   }
 
+  // Prune expired rows in the background
+  startRetention();
+
   // Create Express app
   const app = createApp();
 
@@ -59,6 +62,7 @@ async function main(): Promise<void> {
       await wsServer.close();
       
       // Close database
+      stopRetention();
       await closeDatabase();
       
       logger.info('Shutdown complete');
@@ -6,46 +6,119 @@ import {
   asyncHandler 
 } from '../middleware';
 import { 
-  HardwareBreathSampleSchema, 
+  HardwareRawPayloadSchema, 
+  HardwareRollupBatchSchema,
   HistoryQuerySchema,
+  RollupHistoryQuerySchema,
+  ConflictError,
   type ApiResponse,
   type RawSampleResponse,
+  type RollupResponse,
   type LatestSampleResponse,
   type HistoryResponse,
+  type RollupHistoryResponse,
+  type RollupHistoryQuery,
   type RawBreathSample,
+  type HardwareRawPayloadRequest,
+  type BreathRollup,
+  type HardwareRollupBatchRequest,
 } from '../types';
 
 const router = Router();
 
+/**
+ * Largest difference between a device's clock and ours (request latency
+ * included) at which device-dated rollup buckets are still accepted
+ */
+const MAX_DEVICE_CLOCK_SKEW_MS = 30000;
+
 /**
  * POST /api/v1/breathing/raw
- * Receive raw breath sample from hardware device
+ * Receive raw breath sample(s) from hardware device
  * Accepts simplified payload: { raw: number, voltage: number }
- * Device ID and timestamp are added server-side
+ * or a batch: { batchId?, samples: [{ raw, voltage, ageMs? }, ...] } (oldest first)
+ * Device ID and timestamp are added server-side; ageMs (time since capture)
+ * is subtracted from the receipt time
  */
 router.post(
   '/raw',
-  validateBody(HardwareBreathSampleSchema),
+  validateBody(HardwareRawPayloadSchema),
   asyncHandler(async (req: Request, res: Response) => {
-    // Transform hardware payload to internal format
-    const internalSample: RawBreathSample = {
+    const body = req.body as HardwareRawPayloadRequest;
+    const hardwareSamples = 'samples' in body ? body.samples : [body];
+    const receivedAtMs = Date.now();
+
+    // Transform hardware payload to internal format, dating each sample by its age
+    const internalSamples: RawBreathSample[] = hardwareSamples.map(hardwareSample => ({
       deviceId: 'rpi-breath-sensor',
-      timestamp: Math.floor(Date.now() / 1000),
-      rawValue: req.body.raw,
-    };
+      timestamp: Math.floor((receivedAtMs - (hardwareSample.ageMs ?? 0)) / 1000),
+      rawValue: hardwareSample.raw,
+    }));
 
-    const { processed, alert } = await breathingService.processRawSample(internalSample);
+    const batchId = 'samples' in body ? body.batchId : undefined;
+    const { processed, alerts, duplicate } =
+      await breathingService.processRawBatch(internalSamples, batchId);
+    const alertTriggered = alerts.length > 0;
 
     const response: ApiResponse<RawSampleResponse> = {
       success: true,
       data: {
         received: true,
+        sampleCount: hardwareSamples.length,
         processed,
-        alertTriggered: alert !== null,
+        alertTriggered,
+        duplicate,
       },
       timestamp: Date.now(),
     };
 
+    // Already stored: acknowledge so the device stops retrying
+    res.status(duplicate ? 200 : 201).json(response);
+  })
+);
+
+/**
+ * POST /api/v1/breathing/rollup
+ * Receive 1 s / 10 s / 60 s rollup summaries from hardware device
+ * Accepts { sentAt?, records: [{ res, t, n, min, max, mean, breaths }] }
+ * Buckets are dated by the device clock; sentAt (device Unix ms) lets us
+ * refuse them while that clock is off, so rollups never disagree with
+ * server-dated raw history
+ */
+router.post(
+  '/rollup',
+  validateBody(HardwareRollupBatchSchema),
+  asyncHandler(async (req: Request, res: Response) => {
+    const { sentAt, records } = req.body as HardwareRollupBatchRequest;
+
+    if (sentAt !== undefined) {
+      const skewMs = Date.now() - sentAt;
+      if (Math.abs(skewMs) > MAX_DEVICE_CLOCK_SKEW_MS) {
+        throw new ConflictError(
+          `Device clock is off by ${Math.round(skewMs / 1000)} s; rollups refused until it is synchronized`
+        );
+      }
+    }
+
+    const rollups: BreathRollup[] = records.map(record => ({
+      deviceId: 'rpi-breath-sensor',
+      resolutionSec: record.res,
+      bucketStart: record.t,
+      count: record.n,
+      min: record.min,
+      max: record.max,
+      mean: record.mean,
+      breaths: record.breaths,
+    }));
+
+    const received = await breathingService.storeRollups(rollups);
+
+    const response: ApiResponse<RollupResponse> = {
+      success: true,
+      data: { received },
+      timestamp: Date.now(),
+    };
+
     res.status(201).json(response);
   })
 );
@@ -102,5 +175,42 @@ router.get(
   })
 );
 
+/**
+ * GET /api/v1/breathing/history/rollups
+ * Get device rollups for a time range, served only from the rollup table
+ * Resolution (1 s, 10 s, 60 s, or 60 s rows merged into wider buckets for
+ * long ranges) is chosen from the range length; at most 1000 buckets
+ * Query params: from, to (Unix seconds; default: last hour), deviceId
+ */
+router.get(
+  '/history/rollups',
+  validateQuery(RollupHistoryQuerySchema),
+  asyncHandler(async (req: Request, res: Response) => {
+    const query = req.query as unknown as RollupHistoryQuery;
+    const to = query.to ?? Math.floor(Date.now() / 1000);
+    const from = query.from ?? to - 3600;
+
+    const { resolutionSec, rollups } = await breathingService.getRollupHistory({
+      deviceId: query.deviceId ?? 'rpi-breath-sensor',
+      from,
+      to,
+    });
+
+    const response: ApiResponse<RollupHistoryResponse> = {
+      success: true,
+      data: {
+        resolutionSec,
+        from,
+        to,
+        rollups,
+        count: rollups.length,
+      },
+      timestamp: Date.now(),
+    };
+
+    res.json(response);
+  })
+);
+
 export default router;
 
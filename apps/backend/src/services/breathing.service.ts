@@ -1,63 +1,135 @@
 import type { 
   RawBreathSample, 
   ProcessedBreathingSample, 
+  BreathRollup,
   Alert 
 } from '../types';
-import { rawSamplesRepo, processedSamplesRepo } from '../storage';
+import {
+  rawSamplesRepo,
+  rawBatchesRepo,
+  processedSamplesRepo,
+  rollupsRepo,
+  transaction,
+} from '../storage';
 import { processingPipeline } from '../processing';
 import { alertService } from './alert.service';
 import { wsServer } from '../websocket/server';
 import { logger } from '../utils/logger';
 
+/** Rollup resolutions stored by devices, finest first (seconds) */
+const ROLLUP_RESOLUTIONS_SEC = [1, 10, 60];
+
+/** Most rollup buckets returned by one history query */
+const MAX_ROLLUP_POINTS = 1000;
+
 /**
  * Main service for breathing data processing
  */
 class BreathingService {
   /**
-   * Process a new raw breath sample
-   * This is the main entry point for incoming device data
+   * Process a batch of raw samples from one device, oldest first
+   * This is the main entry point for incoming device data.
+   * Stores each table with a single insert and broadcasts only the
+   * newest sample, so cost per request barely grows with batch size.
+   * With a batchId, a batch already stored (a retry after a lost
+   * response) is acknowledged without storing it again.
    */
-  async processRawSample(sample: RawBreathSample): Promise<{
+  async processRawBatch(samples: RawBreathSample[], batchId?: string): Promise<{
     processed: ProcessedBreathingSample | null;
-    alert: Alert | null;
+    alerts: Alert[];
+    duplicate: boolean;
   }> {
-    logger.debug('Processing raw sample', { 
-      deviceId: sample.deviceId, 
-      timestamp: sample.timestamp,
-      rawValue: sample.rawValue 
-    });
+    const deviceId = samples[0]?.deviceId;
+    logger.debug('Processing raw batch', { deviceId, batchId, count: samples.length });
 
-    // 1. Store raw sample
-    await rawSamplesRepo.insert(sample);
+    const saved = await transaction(async client => {
+      // 1. Claim the batch; samples and claim commit or roll back together
+      if (batchId && deviceId &&
+          !(await rawBatchesRepo.claim(deviceId, batchId, samples.length, client))) {
+        return null;
+      }
 
-    // 2. Run through processing pipeline
-    const result = processingPipeline.process(sample);
+      // 2. Store raw samples
+      await rawSamplesRepo.insertMany(samples, client);
 
-    // 3. Create processed sample
-    const processedSample: Omit<ProcessedBreathingSample, 'id'> = {
-      deviceId: sample.deviceId,
-      timestamp: sample.timestamp,
-      breathingRate: Math.round(result.metrics.breathingRate * 100) / 100,
-      breathLengthMs: result.metrics.breathLengthMs,
-      variability: Math.round(result.metrics.variability * 10000) / 10000,
-      breathDepth: result.metrics.breathDepth,
-      apneaRisk: result.apneaRisk,
-    };
+      // 3. Run through processing pipeline (order matters, so sequentially)
+      const processedSamples = samples.map(sample => this.toProcessedSample(sample));
+
+      // 4. Store processed samples
+      return processedSamplesRepo.insertMany(processedSamples, client);
+    });
 
-    // 4. Store processed sample
-    const saved = await processedSamplesRepo.insert(processedSample);
+    if (saved === null) {
+      logger.info('Duplicate raw batch ignored', { deviceId, batchId });
+      return { processed: null, alerts: [], duplicate: true };
+    }
 
-    // 5. Evaluate alert conditions
-    const alert = alertService.evaluate(saved);
+    // 5. Evaluate alert conditions for every sample
+    const alerts: Alert[] = [];
+    for (const sample of saved) {
+      const alert = alertService.evaluate(sample);
+      if (alert) {
+        alerts.push(alert);
+      }
+    }
 
     // 6. Emit WebSocket events
-    wsServer.broadcastProcessedSample(saved);
-    
-    if (alert) {
+    const latest = saved.length > 0 ? saved[saved.length - 1] : null;
+    if (latest) {
+      wsServer.broadcastProcessedSample(latest);
+    }
+    for (const alert of alerts) {
       wsServer.broadcastAlert(alert);
     }
 
-    return { processed: saved, alert };
+    return { processed: latest, alerts, duplicate: false };
+  }
+
+  /**
+   * Store rollup summaries computed on the device
+   */
+  async storeRollups(rollups: BreathRollup[]): Promise<number> {
+    logger.debug('Storing rollups', { count: rollups.length });
+    return rollupsRepo.insertMany(rollups);
+  }
+
+  /**
+   * Get rollup history for a time range without touching raw samples
+   * Picks the finest resolution that keeps the result to a chartable size;
+   * spans too long even for 60 s buckets are merged into wider ones
+   */
+  async getRollupHistory(options: {
+    deviceId: string;
+    from: number;
+    to: number;
+  }): Promise<{ resolutionSec: number; rollups: BreathRollup[] }> {
+    // A range not aligned to the resolution touches one extra bucket
+    const span = options.to - options.from;
+    const maxSpanBuckets = MAX_ROLLUP_POINTS - 1;
+    const stored = ROLLUP_RESOLUTIONS_SEC.find(res => span / res <= maxSpanBuckets);
+
+    if (stored !== undefined) {
+      const rollups = await rollupsRepo.getByTimeRange(
+        options.deviceId,
+        stored,
+        options.from,
+        options.to
+      );
+      return { resolutionSec: stored, rollups };
+    }
+
+    // Coarsest stored resolution, grouped into a multiple of it
+    const base = ROLLUP_RESOLUTIONS_SEC[ROLLUP_RESOLUTIONS_SEC.length - 1];
+    const resolutionSec = Math.ceil(span / maxSpanBuckets / base) * base;
+    const rollups = await rollupsRepo.getMerged(
+      options.deviceId,
+      base,
+      resolutionSec,
+      options.from,
+      options.to
+    );
+
+    return { resolutionSec, rollups };
   }
 
   /**
@@ -93,6 +165,23 @@ class BreathingService {
   ): Promise<RawBreathSample[]> {
     return rawSamplesRepo.getRecent(deviceId, limit);
   }
+
+  /**
+   * Run one raw sample through the processing pipeline
+   */
+  private toProcessedSample(sample: RawBreathSample): Omit<ProcessedBreathingSample, 'id'> {
+    const result = processingPipeline.process(sample);
+
+    return {
+      deviceId: sample.deviceId,
+      timestamp: sample.timestamp,
+      breathingRate: Math.round(result.metrics.breathingRate * 100) / 100,
+      breathLengthMs: result.metrics.breathLengthMs,
+      variability: Math.round(result.metrics.variability * 10000) / 10000,
+      breathDepth: result.metrics.breathDepth,
+      apneaRisk: result.apneaRisk,
+    };
+  }
 }
 
 export const breathingService = new BreathingService();
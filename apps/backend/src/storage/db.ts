@@ -47,16 +47,18 @@ export function getPool(): Pool {
 
 /**
  * Execute a query
+ * Pass the client from transaction() to run it inside that transaction
  */
 export async function query<T>(
   text: string,
-  params?: unknown[]
+  params?: unknown[],
+  client?: PoolClient
 ): Promise<T[]> {
-  const pool = getPool();
+  const executor = client ?? getPool();
   const start = Date.now();
   
   try {
-    const result = await pool.query(text, params);
+    const result = await executor.query(text, params);
     const duration = Date.now() - start;
     
     logger.debug('Executed query', { text, duration, rows: result.rowCount });
@@ -153,6 +155,29 @@ export async function initSchema(): Promise<void> {
     )
     `,
     `
+    CREATE TABLE IF NOT EXISTS breath_rollups (
+      device_id VARCHAR(64) NOT NULL,
+      resolution_sec INTEGER NOT NULL,
+      bucket_start BIGINT NOT NULL,
+      sample_count INTEGER NOT NULL,
+      min_value INTEGER NOT NULL,
+      max_value INTEGER NOT NULL,
+      mean_value DECIMAL(7,2) NOT NULL,
+      breaths INTEGER NOT NULL,
+      created_at TIMESTAMPTZ DEFAULT NOW(),
+      PRIMARY KEY (device_id, resolution_sec, bucket_start)
+    )
+    `,
+    `
+    CREATE TABLE IF NOT EXISTS raw_batches (
+      device_id VARCHAR(64) NOT NULL,
+      batch_id VARCHAR(64) NOT NULL,
+      sample_count INTEGER NOT NULL,
+      created_at TIMESTAMPTZ DEFAULT NOW(),
+      PRIMARY KEY (device_id, batch_id)
+    )
+    `,
+    `
     CREATE INDEX IF NOT EXISTS idx_raw_device_timestamp 
       ON raw_breath_samples(device_id, timestamp DESC)
     `,
@@ -160,6 +185,10 @@ export async function initSchema(): Promise<void> {
     CREATE INDEX IF NOT EXISTS idx_processed_device_timestamp 
       ON processed_breath_samples(device_id, timestamp DESC)
     `,
+    `
+    CREATE INDEX IF NOT EXISTS idx_raw_batches_created_at 
+      ON raw_batches(created_at)
+    `,
   ];
 
   for (const sql of createTableQueries) {
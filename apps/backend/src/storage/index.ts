@@ -1,4 +1,7 @@
 export * from './db';
 export { rawSamplesRepo } from './raw-samples.repo';
+export { rawBatchesRepo } from './raw-batches.repo';
 export { processedSamplesRepo } from './processed-samples.repo';
+export { rollupsRepo } from './rollups.repo';
+export { startRetention, stopRetention } from './retention';
 
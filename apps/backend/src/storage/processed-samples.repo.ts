@@ -1,4 +1,5 @@
 import { v4 as uuidv4 } from 'uuid';
+import type { PoolClient } from 'pg';
 import { query, queryOne } from './db';
 import type { ProcessedBreathingSample, ApneaRiskLevel } from '../types';
 
@@ -63,6 +64,46 @@ export const processedSamplesRepo = {
     return { id, ...sample };
   },
 
+  /**
+   * Insert a batch of processed samples in one statement
+   * Pass a transaction client to store them atomically with other writes
+   */
+  async insertMany(
+    samples: Omit<ProcessedBreathingSample, 'id'>[],
+    client?: PoolClient
+  ): Promise<ProcessedBreathingSample[]> {
+    if (samples.length === 0) {
+      return [];
+    }
+
+    const saved = samples.map(sample => ({ id: uuidv4(), ...sample }));
+    const values: unknown[] = [];
+    const placeholders = saved.map((sample, i) => {
+      const base = i * 8;
+      values.push(
+        sample.id,
+        sample.deviceId,
+        sample.timestamp,
+        sample.breathingRate,
+        sample.breathLengthMs,
+        sample.variability,
+        sample.breathDepth,  // Stored in signal_quality column
+        sample.apneaRisk
+      );
+      return `($${base + 1}, $${base + 2}, $${base + 3}, $${base + 4}, $${base + 5}, $${base + 6}, $${base + 7}, $${base + 8})`;
+    });
+
+    await query(
+      `INSERT INTO processed_breath_samples
+       (id, device_id, timestamp, breathing_rate, breath_length_ms, variability, signal_quality, apnea_risk)
+       VALUES ${placeholders.join(', ')}`,
+      values,
+      client
+    );
+
+    return saved;
+  },
+
   /**
    * Get the latest processed sample for a device
    */
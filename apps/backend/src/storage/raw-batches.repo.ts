@@ -0,0 +1,50 @@
+import type { PoolClient } from 'pg';
+import { query } from './db';
+
+/**
+ * Repository of raw sample batches already stored
+ * Lets devices retry a batch whose response was lost without the
+ * samples being stored twice
+ */
+export const rawBatchesRepo = {
+  /**
+   * Record a batch as stored
+   * Run inside the transaction that stores its samples, so a failed
+   * attempt leaves the batch unclaimed for the retry
+   * @returns false if the batch was stored before
+   */
+  async claim(
+    deviceId: string,
+    batchId: string,
+    sampleCount: number,
+    client?: PoolClient
+  ): Promise<boolean> {
+    const rows = await query<{ batch_id: string }>(
+      `INSERT INTO raw_batches (device_id, batch_id, sample_count)
+       VALUES ($1, $2, $3)
+       ON CONFLICT (device_id, batch_id) DO NOTHING
+       RETURNING batch_id`,
+      [deviceId, batchId, sampleCount],
+      client
+    );
+
+    return rows.length > 0;
+  },
+
+  /**
+   * Delete old batch records (data retention)
+   */
+  async deleteOlderThan(createdBefore: Date): Promise<number> {
+    const result = await query<{ count: string }>(
+      `WITH deleted AS (
+         DELETE FROM raw_batches
+         WHERE created_at < $1
+         RETURNING 1
+       )
+       SELECT COUNT(*) as count FROM deleted`,
+      [createdBefore]
+    );
+
+    return parseInt(result[0]?.count || '0', 10);
+  },
+};
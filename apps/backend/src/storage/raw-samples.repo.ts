@@ -1,4 +1,5 @@
 import { v4 as uuidv4 } from 'uuid';
+import type { PoolClient } from 'pg';
 import { query, queryOne } from './db';
 import type { RawBreathSample } from '../types';
 
@@ -32,6 +33,32 @@ export const rawSamplesRepo = {
     return id;
   },
 
+  /**
+   * Insert a batch of raw samples in one statement
+   * Pass a transaction client to store them atomically with other writes
+   */
+  async insertMany(samples: RawBreathSample[], client?: PoolClient): Promise<number> {
+    if (samples.length === 0) {
+      return 0;
+    }
+
+    const values: unknown[] = [];
+    const placeholders = samples.map((sample, i) => {
+      const base = i * 4;
+      values.push(uuidv4(), sample.deviceId, sample.timestamp, sample.rawValue);
+      return `($${base + 1}, $${base + 2}, $${base + 3}, $${base + 4})`;
+    });
+
+    await query(
+      `INSERT INTO raw_breath_samples (id, device_id, timestamp, raw_value)
+       VALUES ${placeholders.join(', ')}`,
+      values,
+      client
+    );
+
+    return samples.length;
+  },
+
   /**
    * Get recent raw samples for a device
    */
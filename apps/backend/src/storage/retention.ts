@@ -0,0 +1,45 @@
+import { config } from '../config';
+import { logger } from '../utils/logger';
+import { rawBatchesRepo } from './raw-batches.repo';
+
+let pruneTimer: NodeJS.Timeout | null = null;
+
+/**
+ * Delete rows past their retention period
+ * Batch ids only need to outlive a device's retries, so they are
+ * dropped long before the samples they describe
+ */
+async function prune(): Promise<void> {
+  try {
+    const deleted = await rawBatchesRepo.deleteOlderThan(
+      new Date(Date.now() - config.retention.rawBatchMs)
+    );
+    if (deleted > 0) {
+      logger.info('Pruned raw batch ids', { deleted });
+    }
+  } catch (error) {
+    logger.error('Retention run failed', { error });
+  }
+}
+
+/**
+ * Run retention now and then periodically
+ */
+export function startRetention(): void {
+  if (pruneTimer) {
+    return;
+  }
+  void prune();
+  pruneTimer = setInterval(() => void prune(), config.retention.pruneIntervalMs);
+  pruneTimer.unref();
+}
+
+/**
+ * Stop the periodic retention run
+ */
+export function stopRetention(): void {
+  if (pruneTimer) {
+    clearInterval(pruneTimer);
+    pruneTimer = null;
+  }
+}
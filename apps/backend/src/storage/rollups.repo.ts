@@ -0,0 +1,132 @@
+import { query } from './db';
+import type { BreathRollup } from '../types';
+
+/**
+ * Database row type for rollups
+ */
+interface RollupRow {
+  device_id: string;
+  resolution_sec: number;
+  bucket_start: string;
+  sample_count: number;
+  min_value: number;
+  max_value: number;
+  mean_value: string;
+  breaths: number;
+}
+
+/**
+ * Convert database row to domain type
+ */
+function rowToRollup(row: RollupRow): BreathRollup {
+  return {
+    deviceId: row.device_id,
+    resolutionSec: row.resolution_sec,
+    bucketStart: parseInt(row.bucket_start, 10),
+    count: row.sample_count,
+    min: row.min_value,
+    max: row.max_value,
+    mean: parseFloat(row.mean_value),
+    breaths: row.breaths,
+  };
+}
+
+/**
+ * Repository for device-computed rollup storage
+ */
+export const rollupsRepo = {
+  /**
+   * Insert a batch of rollups in one statement
+   * Re-sent buckets (e.g. after a lost response) overwrite the stored row
+   */
+  async insertMany(rollups: BreathRollup[]): Promise<number> {
+    if (rollups.length === 0) {
+      return 0;
+    }
+
+    const values: unknown[] = [];
+    const placeholders = rollups.map((rollup, i) => {
+      const base = i * 8;
+      values.push(
+        rollup.deviceId,
+        rollup.resolutionSec,
+        rollup.bucketStart,
+        rollup.count,
+        rollup.min,
+        rollup.max,
+        rollup.mean,
+        rollup.breaths
+      );
+      return `($${base + 1}, $${base + 2}, $${base + 3}, $${base + 4}, $${base + 5}, $${base + 6}, $${base + 7}, $${base + 8})`;
+    });
+
+    await query(
+      `INSERT INTO breath_rollups
+       (device_id, resolution_sec, bucket_start, sample_count, min_value, max_value, mean_value, breaths)
+       VALUES ${placeholders.join(', ')}
+       ON CONFLICT (device_id, resolution_sec, bucket_start) DO UPDATE SET
+         sample_count = EXCLUDED.sample_count,
+         min_value = EXCLUDED.min_value,
+         max_value = EXCLUDED.max_value,
+         mean_value = EXCLUDED.mean_value,
+         breaths = EXCLUDED.breaths`,
+      values
+    );
+
+    return rollups.length;
+  },
+
+  /**
+   * Get rollups at one resolution in a time range
+   */
+  async getByTimeRange(
+    deviceId: string,
+    resolutionSec: number,
+    fromTimestamp: number,
+    toTimestamp: number
+  ): Promise<BreathRollup[]> {
+    const rows = await query<RollupRow>(
+      `SELECT device_id, resolution_sec, bucket_start, sample_count,
+              min_value, max_value, mean_value, breaths
+       FROM breath_rollups
+       WHERE device_id = $1 AND resolution_sec = $2
+         AND bucket_start >= $3 AND bucket_start <= $4
+       ORDER BY bucket_start ASC`,
+      [deviceId, resolutionSec, fromTimestamp, toTimestamp]
+    );
+
+    return rows.map(rowToRollup);
+  },
+
+  /**
+   * Merge stored rollups into wider buckets in a time range
+   * Counts and breaths add up, min/max combine and the mean is
+   * weighted by sample count
+   */
+  async getMerged(
+    deviceId: string,
+    storedResolutionSec: number,
+    resolutionSec: number,
+    fromTimestamp: number,
+    toTimestamp: number
+  ): Promise<BreathRollup[]> {
+    const rows = await query<RollupRow>(
+      `SELECT device_id,
+              $3::integer AS resolution_sec,
+              (bucket_start / $3) * $3 AS bucket_start,
+              SUM(sample_count)::integer AS sample_count,
+              MIN(min_value) AS min_value,
+              MAX(max_value) AS max_value,
+              SUM(mean_value * sample_count) / SUM(sample_count) AS mean_value,
+              SUM(breaths)::integer AS breaths
+       FROM breath_rollups
+       WHERE device_id = $1 AND resolution_sec = $2
+         AND bucket_start >= $4 AND bucket_start <= $5
+       GROUP BY device_id, 3
+       ORDER BY bucket_start ASC`,
+      [deviceId, storedResolutionSec, resolutionSec, fromTimestamp, toTimestamp]
+    );
+
+    return rows.map(rowToRollup);
+  },
+};
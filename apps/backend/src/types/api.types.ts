@@ -1,5 +1,5 @@
 import { z } from 'zod';
-import type { ProcessedBreathingSample, Alert } from './domain.types';
+import type { ProcessedBreathingSample, Alert, BreathRollup } from './domain.types';
 
 /**
  * API Request/Response types and validation schemas
@@ -20,15 +20,63 @@ export type RawBreathSampleRequest = z.infer<typeof RawBreathSampleSchema>;
 
 /**
  * Schema for hardware payload from Raspberry Pi
- * Simpler format - deviceId and timestamp added server-side
+ * Simpler format - deviceId and timestamp added server-side; ageMs lets
+ * the server place queued samples without trusting the device clock
  */
 export const HardwareBreathSampleSchema = z.object({
   raw: z.number().int().min(0).max(1023),      // 10-bit MCP3008 ADC range
   voltage: z.number().min(0).max(3.3),          // Voltage reading (0-3.3V)
+  ageMs: z.number().int().min(0).max(86400000).optional(), // Time from capture to send
 });
 
 export type HardwareBreathSampleRequest = z.infer<typeof HardwareBreathSampleSchema>;
 
+/**
+ * Schema for a batch of hardware samples, oldest first
+ * Lets devices (and load tests) amortize request overhead; a batchId
+ * makes retries idempotent
+ */
+export const HardwareBreathBatchSchema = z.object({
+  batchId: z.string().min(1).max(64).optional(),  // Same id on every retry of the batch
+  samples: z.array(HardwareBreathSampleSchema).min(1).max(500),
+});
+
+export type HardwareBreathBatchRequest = z.infer<typeof HardwareBreathBatchSchema>;
+
+/**
+ * Schema for POST /breathing/raw: a single sample or a batch
+ */
+export const HardwareRawPayloadSchema = z.union([
+  HardwareBreathSampleSchema,
+  HardwareBreathBatchSchema,
+]);
+
+export type HardwareRawPayloadRequest = z.infer<typeof HardwareRawPayloadSchema>;
+
+/**
+ * Schema for a single device-side rollup record
+ * Compact keys keep the payload small on poor links
+ */
+export const HardwareRollupRecordSchema = z.object({
+  res: z.union([z.literal(1), z.literal(10), z.literal(60)]),
+  t: z.number().int().positive(),
+  n: z.number().int().positive(),
+  min: z.number().int().min(0).max(1023),
+  max: z.number().int().min(0).max(1023),
+  mean: z.number().min(0).max(1023),
+  breaths: z.number().int().min(0),
+});
+
+/**
+ * Schema for a batch of rollup records from Raspberry Pi
+ */
+export const HardwareRollupBatchSchema = z.object({
+  sentAt: z.number().int().positive().optional(),  // Device clock at send (Unix ms)
+  records: z.array(HardwareRollupRecordSchema).min(1).max(256),
+});
+
+export type HardwareRollupBatchRequest = z.infer<typeof HardwareRollupBatchSchema>;
+
 /**
  * Schema for history query parameters
  */
@@ -41,6 +89,20 @@ export const HistoryQuerySchema = z.object({
 
 export type HistoryQuery = z.infer<typeof HistoryQuerySchema>;
 
+/**
+ * Schema for rollup history query parameters
+ * Defaults to the last hour ending now
+ */
+export const RollupHistoryQuerySchema = z.object({
+  from: z.coerce.number().int().positive().optional(),
+  to: z.coerce.number().int().positive().optional(),
+  deviceId: z.string().optional(),
+}).refine(q => q.from === undefined || q.to === undefined || q.from <= q.to, {
+  message: 'from must not be after to',
+});
+
+export type RollupHistoryQuery = z.infer<typeof RollupHistoryQuerySchema>;
+
 // ============ Response Types ============
 
 /**
@@ -77,8 +139,17 @@ export interface HealthResponse {
  */
 export interface RawSampleResponse {
   received: boolean;
+  sampleCount: number;
   processed: ProcessedBreathingSample | null;
   alertTriggered: boolean;
+  duplicate: boolean;     // Batch was stored by an earlier attempt
+}
+
+/**
+ * Response for POST /breathing/rollup
+ */
+export interface RollupResponse {
+  received: number;
 }
 
 /**
@@ -95,6 +166,17 @@ export interface HistoryResponse {
   hasMore: boolean;
 }
 
+/**
+ * Response for GET /breathing/history/rollups
+ */
+export interface RollupHistoryResponse {
+  resolutionSec: number;
+  from: number;
+  to: number;
+  rollups: BreathRollup[];
+  count: number;
+}
+
 // ============ WebSocket Event Types ============
 
 export type WSEventType = 'PROCESSED_SAMPLE' | 'ALERT' | 'CONNECTION_ACK' | 'ERROR';
@@ -12,6 +12,21 @@ export interface RawBreathSample {
   rawValue: number;  // Potentiometer value (0-1023 typical range)
 }
 
+/**
+ * Rollup summary computed on the device for one time bucket
+ * Lets long-range history queries avoid touching raw samples
+ */
+export interface BreathRollup {
+  deviceId: string;
+  resolutionSec: number;  // Bucket width: 1, 10 or 60
+  bucketStart: number;    // Unix seconds, aligned to resolution
+  count: number;          // Samples in bucket
+  min: number;            // Minimum raw value
+  max: number;            // Maximum raw value
+  mean: number;           // Mean raw value
+  breaths: number;        // Breath onsets in bucket
+}
+
 /**
  * Processed breathing sample with calculated metrics
  */